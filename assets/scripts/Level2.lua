@@ -1,79 +1,80 @@
 Level = {
     ----------------------------------------------------
     -- Table to define the list of assets
+    -- (textures with atlas = true share atlas pages)
     ----------------------------------------------------
     assets = {
         [0] =
         { type = "texture", id = "tilemap-texture",             file = "./assets/tilemaps/desert.png" },
-        { type = "texture", id = "tank-texture",                file = "./assets/images/tank-panther-spritesheet.png" },
-        { type = "texture", id = "su27-texture",                file = "./assets/images/su27-spritesheet.png" },
-        { type = "texture", id = "f22-texture",                 file = "./assets/images/f22-spritesheet.png" },
-        { type = "texture", id = "fw190-texture",               file = "./assets/images/fw190-spritesheet.png" },
-        { type = "texture", id = "upf7-texture",                file = "./assets/images/upf7-spritesheet.png" },
-        { type = "texture", id = "bf109-texture",               file = "./assets/images/bf109-spritesheet.png" },
-        { type = "texture", id = "bomber-texture",              file = "./assets/images/bomber-spritesheet.png" },
-        { type = "texture", id = "carrier-texture",             file = "./assets/images/carrier.png" },
-        { type = "texture", id = "boat-texture",                file = "./assets/images/boat.png" },
-        { type = "texture", id = "tank-tiger-up-texture",       file = "./assets/images/tank-tiger-up.png" },
-        { type = "texture", id = "tank-tiger-right-texture",    file = "./assets/images/tank-tiger-right.png" },
-        { type = "texture", id = "tank-tiger-down-texture",     file = "./assets/images/tank-tiger-down.png" },
-        { type = "texture", id = "tank-tiger-left-texture",     file = "./assets/images/tank-tiger-left.png" },
-        { type = "texture", id = "tank-tiger-killed-texture",   file = "./assets/images/tank-tiger-killed.png" },
-        { type = "texture", id = "tank-panther-up-texture",     file = "./assets/images/tank-panther-up.png" },
-        { type = "texture", id = "tank-panther-right-texture",  file = "./assets/images/tank-panther-right.png" },
-        { type = "texture", id = "tank-panther-down-texture",   file = "./assets/images/tank-panther-down.png" },
-        { type = "texture", id = "tank-panther-left-texture",   file = "./assets/images/tank-panther-left.png" },
-        { type = "texture", id = "tank-panther-killed-texture", file = "./assets/images/tank-panther-killed.png" },
-        { type = "texture", id = "truck-ford-up-texture",       file = "./assets/images/truck-ford-up.png" },
-        { type = "texture", id = "truck-ford-right-texture",    file = "./assets/images/truck-ford-right.png" },
-        { type = "texture", id = "truck-ford-down-texture",     file = "./assets/images/truck-ford-down.png" },
-        { type = "texture", id = "truck-ford-left-texture",     file = "./assets/images/truck-ford-left.png" },
-        { type = "texture", id = "truck-ford-killed-texture",   file = "./assets/images/truck-ford-killed.png" },
-        { type = "texture", id = "army-walk-up-texture",        file = "./assets/images/army-walk-up.png" },
-        { type = "texture", id = "army-walk-right-texture",     file = "./assets/images/army-walk-right.png" },
-        { type = "texture", id = "army-walk-down-texture",      file = "./assets/images/army-walk-down.png" },
-        { type = "texture", id = "army-walk-left-texture",      file = "./assets/images/army-walk-left.png" },
-        { type = "texture", id = "army-walk-killed-texture",    file = "./assets/images/army-walk-killed.png" },
-        { type = "texture", id = "army-gun-up-texture",         file = "./assets/images/army-gun-up.png" },
-        { type = "texture", id = "army-gun-right-texture",      file = "./assets/images/army-gun-right.png" },
-        { type = "texture", id = "army-gun-down-texture",       file = "./assets/images/army-gun-down.png" },
-        { type = "texture", id = "army-gun-left-texture",       file = "./assets/images/army-gun-left.png" },
-        { type = "texture", id = "army-gun-killed-texture",     file = "./assets/images/army-gun-killed.png" },
-        { type = "texture", id = "sam-truck-right-texture",     file = "./assets/images/sam-truck-right.png" },
-        { type = "texture", id = "sam-tank-left-texture",       file = "./assets/images/sam-tank-left-spritesheet.png" },
-        { type = "texture", id = "sam-tank-right-texture",      file = "./assets/images/sam-tank-right-spritesheet.png" },
-        { type = "texture", id = "takeoff-base-texture",        file = "./assets/images/takeoff-base.png" },
-        { type = "texture", id = "landing-base-texture",        file = "./assets/images/landing-base.png" },
-        { type = "texture", id = "runway-texture",              file = "./assets/images/runway.png" },
-        { type = "texture", id = "obstacles1-texture",          file = "./assets/images/obstacles-1.png" },
-        { type = "texture", id = "obstacles2-texture",          file = "./assets/images/obstacles-2.png" },
-        { type = "texture", id = "obstacles3-texture",          file = "./assets/images/obstacles-3.png" },
-        { type = "texture", id = "obstacles4-texture",          file = "./assets/images/obstacles-4.png" },
-        { type = "texture", id = "obstacles5-texture",          file = "./assets/images/obstacles-5.png" },
-        { type = "texture", id = "obstacles6-texture",          file = "./assets/images/obstacles-6.png" },
-        { type = "texture", id = "obstacles7-texture",          file = "./assets/images/obstacles-7.png" },
-        { type = "texture", id = "tree1-texture",               file = "./assets/images/tree-1.png" },
-        { type = "texture", id = "tree2-texture",               file = "./assets/images/tree-2.png" },
-        { type = "texture", id = "tree3-texture",               file = "./assets/images/tree-3.png" },
-        { type = "texture", id = "tree4-texture",               file = "./assets/images/tree-4.png" },
-        { type = "texture", id = "tree5-texture",               file = "./assets/images/tree-5.png" },
-        { type = "texture", id = "tree6-texture",               file = "./assets/images/tree-6.png" },
-        { type = "texture", id = "tree7-texture",               file = "./assets/images/tree-7.png" },
-        { type = "texture", id = "tree8-texture",               file = "./assets/images/tree-8.png" },
-        { type = "texture", id = "tree9-texture",               file = "./assets/images/tree-9.png" },
-        { type = "texture", id = "tree10-texture",              file = "./assets/images/tree-10.png" },
-        { type = "texture", id = "tree11-texture",              file = "./assets/images/tree-11.png" },
-        { type = "texture", id = "tree12-texture",              file = "./assets/images/tree-12.png" },
-        { type = "texture", id = "tree13-texture",              file = "./assets/images/tree-13.png" },
-        { type = "texture", id = "tree14-texture",              file = "./assets/images/tree-14.png" },
-        { type = "texture", id = "tree15-texture",              file = "./assets/images/tree-15.png" },
-        { type = "texture", id = "tree16-texture",              file = "./assets/images/tree-16.png" },
-        { type = "texture", id = "tree17-texture",              file = "./assets/images/tree-17.png" },
-        { type = "texture", id = "tree18-texture",              file = "./assets/images/tree-18.png" },
-        { type = "texture", id = "tree19-texture",              file = "./assets/images/tree-19.png" },
-        { type = "texture", id = "tree20-texture",              file = "./assets/images/tree-20.png" },
-        { type = "texture", id = "bullet-texture",              file = "./assets/images/bullet.png" },
-        { type = "texture", id = "radar-texture",               file = "./assets/images/radar-spritesheet.png" },
+        { type = "texture", id = "tank-texture",                file = "./assets/images/tank-panther-spritesheet.png", atlas = true },
+        { type = "texture", id = "su27-texture",                file = "./assets/images/su27-spritesheet.png", atlas = true },
+        { type = "texture", id = "f22-texture",                 file = "./assets/images/f22-spritesheet.png", atlas = true },
+        { type = "texture", id = "fw190-texture",               file = "./assets/images/fw190-spritesheet.png", atlas = true },
+        { type = "texture", id = "upf7-texture",                file = "./assets/images/upf7-spritesheet.png", atlas = true },
+        { type = "texture", id = "bf109-texture",               file = "./assets/images/bf109-spritesheet.png", atlas = true },
+        { type = "texture", id = "bomber-texture",              file = "./assets/images/bomber-spritesheet.png", atlas = true },
+        { type = "texture", id = "carrier-texture",             file = "./assets/images/carrier.png", atlas = true },
+        { type = "texture", id = "boat-texture",                file = "./assets/images/boat.png", atlas = true },
+        { type = "texture", id = "tank-tiger-up-texture",       file = "./assets/images/tank-tiger-up.png", atlas = true },
+        { type = "texture", id = "tank-tiger-right-texture",    file = "./assets/images/tank-tiger-right.png", atlas = true },
+        { type = "texture", id = "tank-tiger-down-texture",     file = "./assets/images/tank-tiger-down.png", atlas = true },
+        { type = "texture", id = "tank-tiger-left-texture",     file = "./assets/images/tank-tiger-left.png", atlas = true },
+        { type = "texture", id = "tank-tiger-killed-texture",   file = "./assets/images/tank-tiger-killed.png", atlas = true },
+        { type = "texture", id = "tank-panther-up-texture",     file = "./assets/images/tank-panther-up.png", atlas = true },
+        { type = "texture", id = "tank-panther-right-texture",  file = "./assets/images/tank-panther-right.png", atlas = true },
+        { type = "texture", id = "tank-panther-down-texture",   file = "./assets/images/tank-panther-down.png", atlas = true },
+        { type = "texture", id = "tank-panther-left-texture",   file = "./assets/images/tank-panther-left.png", atlas = true },
+        { type = "texture", id = "tank-panther-killed-texture", file = "./assets/images/tank-panther-killed.png", atlas = true },
+        { type = "texture", id = "truck-ford-up-texture",       file = "./assets/images/truck-ford-up.png", atlas = true },
+        { type = "texture", id = "truck-ford-right-texture",    file = "./assets/images/truck-ford-right.png", atlas = true },
+        { type = "texture", id = "truck-ford-down-texture",     file = "./assets/images/truck-ford-down.png", atlas = true },
+        { type = "texture", id = "truck-ford-left-texture",     file = "./assets/images/truck-ford-left.png", atlas = true },
+        { type = "texture", id = "truck-ford-killed-texture",   file = "./assets/images/truck-ford-killed.png", atlas = true },
+        { type = "texture", id = "army-walk-up-texture",        file = "./assets/images/army-walk-up.png", atlas = true },
+        { type = "texture", id = "army-walk-right-texture",     file = "./assets/images/army-walk-right.png", atlas = true },
+        { type = "texture", id = "army-walk-down-texture",      file = "./assets/images/army-walk-down.png", atlas = true },
+        { type = "texture", id = "army-walk-left-texture",      file = "./assets/images/army-walk-left.png", atlas = true },
+        { type = "texture", id = "army-walk-killed-texture",    file = "./assets/images/army-walk-killed.png", atlas = true },
+        { type = "texture", id = "army-gun-up-texture",         file = "./assets/images/army-gun-up.png", atlas = true },
+        { type = "texture", id = "army-gun-right-texture",      file = "./assets/images/army-gun-right.png", atlas = true },
+        { type = "texture", id = "army-gun-down-texture",       file = "./assets/images/army-gun-down.png", atlas = true },
+        { type = "texture", id = "army-gun-left-texture",       file = "./assets/images/army-gun-left.png", atlas = true },
+        { type = "texture", id = "army-gun-killed-texture",     file = "./assets/images/army-gun-killed.png", atlas = true },
+        { type = "texture", id = "sam-truck-right-texture",     file = "./assets/images/sam-truck-right.png", atlas = true },
+        { type = "texture", id = "sam-tank-left-texture",       file = "./assets/images/sam-tank-left-spritesheet.png", atlas = true },
+        { type = "texture", id = "sam-tank-right-texture",      file = "./assets/images/sam-tank-right-spritesheet.png", atlas = true },
+        { type = "texture", id = "takeoff-base-texture",        file = "./assets/images/takeoff-base.png", atlas = true },
+        { type = "texture", id = "landing-base-texture",        file = "./assets/images/landing-base.png", atlas = true },
+        { type = "texture", id = "runway-texture",              file = "./assets/images/runway.png", atlas = true },
+        { type = "texture", id = "obstacles1-texture",          file = "./assets/images/obstacles-1.png", atlas = true },
+        { type = "texture", id = "obstacles2-texture",          file = "./assets/images/obstacles-2.png", atlas = true },
+        { type = "texture", id = "obstacles3-texture",          file = "./assets/images/obstacles-3.png", atlas = true },
+        { type = "texture", id = "obstacles4-texture",          file = "./assets/images/obstacles-4.png", atlas = true },
+        { type = "texture", id = "obstacles5-texture",          file = "./assets/images/obstacles-5.png", atlas = true },
+        { type = "texture", id = "obstacles6-texture",          file = "./assets/images/obstacles-6.png", atlas = true },
+        { type = "texture", id = "obstacles7-texture",          file = "./assets/images/obstacles-7.png", atlas = true },
+        { type = "texture", id = "tree1-texture",               file = "./assets/images/tree-1.png", atlas = true },
+        { type = "texture", id = "tree2-texture",               file = "./assets/images/tree-2.png", atlas = true },
+        { type = "texture", id = "tree3-texture",               file = "./assets/images/tree-3.png", atlas = true },
+        { type = "texture", id = "tree4-texture",               file = "./assets/images/tree-4.png", atlas = true },
+        { type = "texture", id = "tree5-texture",               file = "./assets/images/tree-5.png", atlas = true },
+        { type = "texture", id = "tree6-texture",               file = "./assets/images/tree-6.png", atlas = true },
+        { type = "texture", id = "tree7-texture",               file = "./assets/images/tree-7.png", atlas = true },
+        { type = "texture", id = "tree8-texture",               file = "./assets/images/tree-8.png", atlas = true },
+        { type = "texture", id = "tree9-texture",               file = "./assets/images/tree-9.png", atlas = true },
+        { type = "texture", id = "tree10-texture",              file = "./assets/images/tree-10.png", atlas = true },
+        { type = "texture", id = "tree11-texture",              file = "./assets/images/tree-11.png", atlas = true },
+        { type = "texture", id = "tree12-texture",              file = "./assets/images/tree-12.png", atlas = true },
+        { type = "texture", id = "tree13-texture",              file = "./assets/images/tree-13.png", atlas = true },
+        { type = "texture", id = "tree14-texture",              file = "./assets/images/tree-14.png", atlas = true },
+        { type = "texture", id = "tree15-texture",              file = "./assets/images/tree-15.png", atlas = true },
+        { type = "texture", id = "tree16-texture",              file = "./assets/images/tree-16.png", atlas = true },
+        { type = "texture", id = "tree17-texture",              file = "./assets/images/tree-17.png", atlas = true },
+        { type = "texture", id = "tree18-texture",              file = "./assets/images/tree-18.png", atlas = true },
+        { type = "texture", id = "tree19-texture",              file = "./assets/images/tree-19.png", atlas = true },
+        { type = "texture", id = "tree20-texture",              file = "./assets/images/tree-20.png", atlas = true },
+        { type = "texture", id = "bullet-texture",              file = "./assets/images/bullet.png", atlas = true },
+        { type = "texture", id = "radar-texture",               file = "./assets/images/radar-spritesheet.png", atlas = true },
         { type = "font"   , id = "pico8-font-5",                file = "./assets/fonts/pico8.ttf", font_size = 5 },
         { type = "font"   , id = "pico8-font-8",               file = "./assets/fonts/pico8.ttf", font_size = 8 }
     },
@@ -87,7 +88,30 @@ Level = {
         num_rows = 30,
         num_cols = 40,
         tile_size = 32,
-        scale = 2.0
+        scale = 2.0,
+        layers = {}, -- more map files drawn over map_file, in order (empty codes like "--" leave the cell empty)
+        solid_tiles = {} -- tile codes (as in the map file) of the solid tiles, in the collision layer "terrain", e.g. { "13", "17" }
+    },
+
+    ----------------------------------------------------
+    -- table to define the collision detection settings
+    ----------------------------------------------------
+    collision = {
+        broadphase = "spatial_grid", -- "spatial_grid", "dynamic_tree" or "sweep_and_prune"
+        cell_size = 64, -- spatial grid cell size, in pixels
+        fat_margin = 8, -- dynamic tree box margin, in pixels
+        stay_events = false, -- emit a collision stay event every frame while two boxes overlap
+
+        -- layers each collision layer collides with; a boxcollider is in the layer named after
+        -- its entity group (or tag) unless it sets "layer", and can override this with "collides_with";
+        -- the projectiles of an emitter are in the layer "projectiles" unless the emitter sets "layer"
+        -- the solid tiles are in the layer "terrain", and only block the colliders that collide with it
+        layers = {
+            enemies = { "player", "player_projectiles", "obstacles" },
+            obstacles = { "enemies" },
+            projectiles = { "player" },
+            player_projectiles = { "enemies" }
+        }
     },
 
     ----------------------------------------------------
@@ -98,6 +122,7 @@ Level = {
         {
             -- Player
             tag = "player",
+            group = "player",
             components = {
                 transform = {
                     position = { x = 750, y = 450 },
@@ -129,7 +154,8 @@ Level = {
                     projectile_duration = 10, -- seconds
                     repeat_frequency = 0, -- seconds
                     hit_percentage_damage = 10,
-                    friendly = true
+                    friendly = true,
+                    layer = "player_projectiles"
                 },
                 keyboard_controller = {
                     up_velocity = { x = 0, y = -30 },
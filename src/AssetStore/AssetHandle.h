@@ -0,0 +1,10 @@
+#ifndef ASSET_HANDLE_H
+#define ASSET_HANDLE_H
+
+// Index of an asset in the AssetStore, resolved from its id when the asset is loaded
+typedef int TextureHandle;
+typedef int FontHandle;
+
+const int INVALID_ASSET_HANDLE = -1;
+
+#endif
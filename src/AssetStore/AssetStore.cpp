@@ -1,5 +1,7 @@
 #include "AssetStore.h"
 #include "../Logger/Logger.h"
+#include "RectanglePacker.h"
+#include <algorithm>
 #include <SDL2/SDL_image.h>
 
 AssetStore::AssetStore()
@@ -15,69 +17,244 @@ AssetStore::~AssetStore()
 
 void AssetStore::ClearAssets()
 {
-	for (auto texture : textures)
+	for (auto texture : texturePages)
 	{
-		SDL_DestroyTexture(texture.second);
+		SDL_DestroyTexture(texture);
 	}
-	textures.clear();
+	texturePages.clear();
+	textureRegions.clear();
+	textureHandles.clear();
 
+	for (auto& image : atlasImages)
+	{
+		SDL_FreeSurface(image.surface);
+	}
+	atlasImages.clear();
+
+	glyphAtlases.clear();
 	for (auto font : fonts)
 	{
-		TTF_CloseFont(font.second);
+		TTF_CloseFont(font);
 	}
 	fonts.clear();
+	fontHandles.clear();
 }
 
-void AssetStore::AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath)
+TextureHandle AssetStore::SetTextureRegion(const std::string& assetId, const TextureRegion& region)
+{
+	auto handle = textureHandles.find(assetId);
+	if (handle == textureHandles.end())
+	{
+		TextureHandle newHandle = static_cast<TextureHandle>(textureRegions.size());
+		textureRegions.push_back(region);
+		textureHandles.emplace(assetId, newHandle);
+		return newHandle;
+	}
+
+	// An image still waiting for its atlas is dropped
+	for (auto image = atlasImages.begin(); image != atlasImages.end(); image++)
+	{
+		if (image->texture == handle->second)
+		{
+			SDL_FreeSurface(image->surface);
+			atlasImages.erase(image);
+			break;
+		}
+	}
+
+	// A page of its own is released with the texture; the region of an atlas page stays unused
+	int previousPage = textureRegions[handle->second].page;
+	if (previousPage >= 0)
+	{
+		bool isSharedPage = false;
+		for (std::size_t i = 0; i < textureRegions.size(); i++)
+		{
+			isSharedPage |= static_cast<int>(i) != handle->second && textureRegions[i].page == previousPage;
+		}
+		if (!isSharedPage)
+		{
+			SDL_DestroyTexture(texturePages[previousPage]);
+			texturePages[previousPage] = nullptr;
+		}
+	}
+
+	textureRegions[handle->second] = region;
+	return handle->second;
+}
+
+TextureHandle AssetStore::AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath, bool packInAtlas)
 {
 	SDL_Surface* surface = IMG_Load(filePath.c_str());
 
 	if (!surface)
 	{
 		Logger::Err("Could not open image file " + filePath);
-		return;
+		return INVALID_ASSET_HANDLE;
+	}
+
+	if (packInAtlas)
+	{
+		// The region is set when the atlas is built
+		TextureHandle handle = SetTextureRegion(assetId, { -1, { 0, 0, surface->w, surface->h } });
+		atlasImages.push_back({ handle, surface });
+		return handle;
 	}
 
 	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-	SDL_FreeSurface(surface);
 	
-	// Add the texture to the map
-	textures.emplace(assetId, texture);
+	// Add the texture to the store, or replace the texture with the same id
+	TextureHandle handle = SetTextureRegion(assetId, { static_cast<int>(texturePages.size()), { 0, 0, surface->w, surface->h } });
+	texturePages.push_back(texture);
+	SDL_FreeSurface(surface);
 
 	Logger::Log("New texture added to the Asset Store with id = " + assetId);
+	return handle;
 }
 
-SDL_Texture* AssetStore::GetTexture(const std::string& assetId)
+void AssetStore::BuildAtlases(SDL_Renderer* renderer)
 {
-	return textures[assetId];
+	if (atlasImages.empty())
+	{
+		return;
+	}
+
+	// Packing the tallest images first leaves less space under the skyline
+	std::stable_sort(atlasImages.begin(), atlasImages.end(), [](const AtlasImage& a, const AtlasImage& b) {
+		return a.surface->h > b.surface->h;
+		});
+
+	std::vector<RectanglePacker> packers;
+	std::vector<SDL_Surface*> pageSurfaces;
+	for (auto& image : atlasImages)
+	{
+		int paddedWidth = image.surface->w + 2 * atlasPadding;
+		int paddedHeight = image.surface->h + 2 * atlasPadding;
+
+		int page = -1;
+		int x = 0;
+		int y = 0;
+		for (std::size_t i = 0; i < packers.size() && page < 0; i++)
+		{
+			if (packers[i].Pack(paddedWidth, paddedHeight, x, y))
+			{
+				page = static_cast<int>(i);
+			}
+		}
+
+		if (page < 0)
+		{
+			RectanglePacker packer(atlasPageSize, atlasPageSize);
+			SDL_Surface* pageSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasPageSize, atlasPageSize, 32, SDL_PIXELFORMAT_RGBA32);
+			if (pageSurface && packer.Pack(paddedWidth, paddedHeight, x, y))
+			{
+				page = static_cast<int>(packers.size());
+				packers.push_back(packer);
+				pageSurfaces.push_back(pageSurface);
+			}
+			else
+			{
+				// Too big for a page: the image gets a page of its own
+				SDL_FreeSurface(pageSurface);
+				textureRegions[image.texture] = { static_cast<int>(texturePages.size()), { 0, 0, image.surface->w, image.surface->h } };
+				texturePages.push_back(SDL_CreateTextureFromSurface(renderer, image.surface));
+				SDL_FreeSurface(image.surface);
+				continue;
+			}
+		}
+
+		// Copied as is, alpha included
+		SDL_Rect rect = { x + atlasPadding, y + atlasPadding, image.surface->w, image.surface->h };
+		SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(image.surface, NULL, pageSurfaces[page], &rect);
+		SDL_FreeSurface(image.surface);
+
+		// Pages that got an image of their own above come after the atlas pages, so they are numbered later
+		textureRegions[image.texture] = { -2 - page, rect };
+	}
+
+	for (auto pageSurface : pageSurfaces)
+	{
+		texturePages.push_back(SDL_CreateTextureFromSurface(renderer, pageSurface));
+		SDL_FreeSurface(pageSurface);
+	}
+	for (auto& region : textureRegions)
+	{
+		if (region.page <= -2)
+		{
+			region.page = static_cast<int>(texturePages.size() - pageSurfaces.size()) + (-2 - region.page);
+		}
+	}
+
+	Logger::Log("Packed " + std::to_string(atlasImages.size()) + " textures in " + std::to_string(pageSurfaces.size()) + " atlas pages");
+	atlasImages.clear();
+}
+
+TextureHandle AssetStore::GetTextureHandle(const std::string& assetId) const
+{
+	auto handle = textureHandles.find(assetId);
+	if (handle == textureHandles.end())
+	{
+		Logger::Err("No texture in the Asset Store with id = " + assetId);
+		return INVALID_ASSET_HANDLE;
+	}
+
+	return handle->second;
 }
 
-std::map<std::string, SDL_Texture*>& AssetStore::GetTextures()
+int AssetStore::GetNumTextures() const
 {
-	return textures;
+	return static_cast<int>(textureRegions.size());
 }
 
-void AssetStore::AddFont(const std::string& assetId, const std::string& filePath, int fontSize)
+FontHandle AssetStore::AddFont(const std::string& assetId, const std::string& filePath, int fontSize)
 {
 	TTF_Font* font = TTF_OpenFont(filePath.c_str(), fontSize);
 
 	if (!font)
 	{
 		Logger::Err("Could not open font file " + filePath);
-		return;
+		return INVALID_ASSET_HANDLE;
 	}
 	
-	fonts.emplace(assetId, font);
+	auto handle = fontHandles.find(assetId);
+	if (handle != fontHandles.end())
+	{
+		TTF_CloseFont(fonts[handle->second]);
+		fonts[handle->second] = font;
+		glyphAtlases[handle->second].reset();
+		return handle->second;
+	}
+
+	FontHandle newHandle = static_cast<FontHandle>(fonts.size());
+	fonts.push_back(font);
+	glyphAtlases.emplace_back();
+	fontHandles.emplace(assetId, newHandle);
 
 	Logger::Log("New font added to the Asset Store with id = " + assetId);
+	return newHandle;
 }
 
-TTF_Font* AssetStore::GetFont(const std::string& assetId)
+FontHandle AssetStore::GetFontHandle(const std::string& assetId) const
 {
-	return fonts[assetId];
+	auto handle = fontHandles.find(assetId);
+	if (handle == fontHandles.end())
+	{
+		Logger::Err("No font in the Asset Store with id = " + assetId);
+		return INVALID_ASSET_HANDLE;
+	}
+
+	return handle->second;
 }
 
-std::map<std::string, TTF_Font*>& AssetStore::GetFonts()
+void AssetStore::BuildGlyphAtlases(SDL_Renderer* renderer)
 {
-	return fonts;
+	// An atlas that could not be built is kept, so that it is not tried again
+	for (std::size_t font = 0; font < fonts.size(); font++)
+	{
+		if (!glyphAtlases[font])
+		{
+			glyphAtlases[font] = std::make_unique<GlyphAtlas>();
+			glyphAtlases[font]->Build(renderer, fonts[font]);
+		}
+	}
 }
@@ -1,17 +1,60 @@
 #ifndef ASSET_STORE_H
 #define ASSET_STORE_H
 
-#include <map>
+#include "AssetHandle.h"
+#include "GlyphAtlas.h"
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
 
+/*---------------------------------------------------------------------------*/
+// AssetStore
+/*---------------------------------------------------------------------------*/
+// Assets are stored in vectors and handed out as handles (their index) when
+// they are added. The asset ids are only looked up when the level is loaded;
+// drawing indexes the vectors with the handles kept in the components.
+// A texture is a region of a texture page: a page of its own, or an atlas
+// page shared with other small textures packed by BuildAtlases, so that
+// their sprites can be drawn in the same batch.
+/*---------------------------------------------------------------------------*/
+struct TextureRegion
+{
+	int page;
+	SDL_Rect rect;
+};
+
 class AssetStore
 {
 private:
-	std::map<std::string, SDL_Texture*> textures;
-	std::map<std::string, TTF_Font*> fonts;
+	std::vector<SDL_Texture*> texturePages;
+
+	// [Vector index = texture handle]
+	std::vector<TextureRegion> textureRegions;
+	std::unordered_map<std::string, TextureHandle> textureHandles;
+
+	// Images loaded with packInAtlas, waiting for BuildAtlases
+	struct AtlasImage
+	{
+		TextureHandle texture;
+		SDL_Surface* surface;
+	};
+	std::vector<AtlasImage> atlasImages;
+
+	// Size of the atlas pages, and empty pixels around each packed texture so that they do not bleed in each other
+	static const int atlasPageSize = 1024;
+	static const int atlasPadding = 1;
+
+	TextureHandle SetTextureRegion(const std::string& assetId, const TextureRegion& region);
+
+	std::vector<TTF_Font*> fonts;
+	std::unordered_map<std::string, FontHandle> fontHandles;
+
+	// [Vector index = font handle] Built by BuildGlyphAtlases
+	std::vector<std::unique_ptr<GlyphAtlas>> glyphAtlases;
 	// TODO: create a map for audio
 
 public:
@@ -20,16 +63,52 @@ public:
 
 	void ClearAssets();
 	
-	void AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath);
-	SDL_Texture* GetTexture(const std::string& assetId);
-	std::map<std::string, SDL_Texture*>& GetTextures();
+	// Adding an asset id again replaces the asset, and keeps its handle
+	// A texture packed in an atlas can only be drawn once BuildAtlases was called
+	TextureHandle AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath, bool packInAtlas = false);
+	TextureHandle GetTextureHandle(const std::string& assetId) const;
+	int GetNumTextures() const;
 
-	void AddFont(const std::string& assetId, const std::string& filePath, int fontSize);
-	TTF_Font* GetFont(const std::string& assetId);
-	std::map<std::string, TTF_Font*>& GetFonts();
-};
+	// Packs the textures added with packInAtlas since the last call into atlas pages
+	void BuildAtlases(SDL_Renderer* renderer);
 
-#endif
+	// The page of the texture, for drawing; its rectangle in the page is given by GetTextureRegion
+	SDL_Texture* GetTexture(TextureHandle texture) const
+	{
+		int page = GetTexturePage(texture);
+		return page >= 0 ? texturePages[page] : nullptr;
+	}
+
+	// Textures with the same page can be drawn in one batch
+	int GetTexturePage(TextureHandle texture) const
+	{
+		return texture >= 0 && texture < static_cast<int>(textureRegions.size()) ? textureRegions[texture].page : -1;
+	}
+
+	// Source rectangles of the texture are offset by the position of its region in the page
+	SDL_Rect GetTextureRegion(TextureHandle texture) const
+	{
+		return GetTexturePage(texture) >= 0 ? textureRegions[texture].rect : SDL_Rect{ 0, 0, 0, 0 };
+	}
 
+	FontHandle AddFont(const std::string& assetId, const std::string& filePath, int fontSize);
+	FontHandle GetFontHandle(const std::string& assetId) const;
 
+	TTF_Font* GetFont(FontHandle font) const
+	{
+		return font >= 0 && font < static_cast<int>(fonts.size()) ? fonts[font] : nullptr;
+	}
 
+	// Rasterizes the glyphs of the fonts added since the last call, so that text can be
+	// recorded for drawing without touching the renderer
+	void BuildGlyphAtlases(SDL_Renderer* renderer);
+
+	// Returns nullptr if the font has no glyph atlas, or it could not be built
+	const GlyphAtlas* GetGlyphAtlas(FontHandle font) const
+	{
+		bool hasGlyphAtlas = font >= 0 && font < static_cast<int>(glyphAtlases.size()) && glyphAtlases[font];
+		return hasGlyphAtlas && glyphAtlases[font]->GetTexture() ? glyphAtlases[font].get() : nullptr;
+	}
+};
+
+#endif
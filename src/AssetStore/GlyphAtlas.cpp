@@ -0,0 +1,85 @@
+#include "GlyphAtlas.h"
+#include "RectanglePacker.h"
+#include "../Logger/Logger.h"
+#include <string>
+#include <vector>
+
+GlyphAtlas::~GlyphAtlas()
+{
+	SDL_DestroyTexture(texture);
+}
+
+bool GlyphAtlas::Build(SDL_Renderer* renderer, TTF_Font* font)
+{
+	if (!font)
+	{
+		return false;
+	}
+
+	std::vector<SDL_Surface*> glyphSurfaces;
+	for (char c = firstChar; c <= lastChar; c++)
+	{
+		// Empty glyphs like the space have no image, only an advance
+		const char text[2] = { c, '\0' };
+		SDL_Surface* surface = TTF_RenderText_Blended(font, text, { 255, 255, 255, 255 });
+		glyphSurfaces.push_back(surface);
+
+		int advance = surface ? surface->w : 0;
+		TTF_GlyphMetrics(font, static_cast<Uint16>(c), NULL, NULL, NULL, NULL, &advance);
+		glyphs[c - firstChar] = { { 0, 0, 0, 0 }, advance };
+	}
+	lineHeight = TTF_FontHeight(font);
+
+	// The page grows until all the glyphs fit, with 1px between them so that they do not bleed in each other
+	int pageSize = 64;
+	bool isPacked = false;
+	while (!isPacked && pageSize <= 4096)
+	{
+		RectanglePacker packer(pageSize, pageSize);
+		isPacked = true;
+		for (std::size_t i = 0; i < glyphSurfaces.size() && isPacked; i++)
+		{
+			SDL_Surface* surface = glyphSurfaces[i];
+			if (!surface)
+			{
+				continue;
+			}
+
+			int x = 0;
+			int y = 0;
+			isPacked = packer.Pack(surface->w + 1, surface->h + 1, x, y);
+			glyphs[i].srcRect = { x, y, surface->w, surface->h };
+		}
+
+		if (!isPacked)
+		{
+			pageSize *= 2;
+		}
+	}
+
+	SDL_Surface* page = isPacked ? SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32) : nullptr;
+	for (std::size_t i = 0; i < glyphSurfaces.size(); i++)
+	{
+		if (page && glyphSurfaces[i])
+		{
+			SDL_Rect dstRect = glyphs[i].srcRect;
+			SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(glyphSurfaces[i], NULL, page, &dstRect);
+		}
+		SDL_FreeSurface(glyphSurfaces[i]);
+	}
+
+	if (!page)
+	{
+		Logger::Err("Could not build the glyph atlas of a font");
+		return false;
+	}
+
+	SDL_DestroyTexture(texture);
+	texture = SDL_CreateTextureFromSurface(renderer, page);
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	SDL_FreeSurface(page);
+
+	Logger::Log("Glyph atlas of " + std::to_string(pageSize) + "x" + std::to_string(pageSize) + " built for a font");
+	return texture != nullptr;
+}
@@ -0,0 +1,51 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <array>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+struct Glyph
+{
+	SDL_Rect srcRect;
+	int advance;
+};
+
+/*---------------------------------------------------------------------------*/
+// GlyphAtlas
+/*---------------------------------------------------------------------------*/
+// The printable ASCII characters of a font rasterized once, in white, into
+// one texture. Each glyph is rendered as a one character text, so its image
+// is a full line high and is drawn at the pen position; text is then drawn
+// as glyph quads tinted with the label color, without any texture upload.
+/*---------------------------------------------------------------------------*/
+class GlyphAtlas
+{
+private:
+	static const char firstChar = ' ';
+	static const char lastChar = '~';
+
+	SDL_Texture* texture = nullptr;
+	std::array<Glyph, lastChar - firstChar + 1> glyphs;
+	int lineHeight = 0;
+
+public:
+	GlyphAtlas() = default;
+	~GlyphAtlas();
+
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+	bool Build(SDL_Renderer* renderer, TTF_Font* font);
+
+	SDL_Texture* GetTexture() const { return texture; }
+	int GetLineHeight() const { return lineHeight; }
+
+	// Characters outside the atlas are drawn as '?'
+	const Glyph& GetGlyph(char c) const
+	{
+		return c >= firstChar && c <= lastChar ? glyphs[c - firstChar] : glyphs['?' - firstChar];
+	}
+};
+
+#endif
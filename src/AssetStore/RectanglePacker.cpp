@@ -0,0 +1,108 @@
+#include "RectanglePacker.h"
+#include <algorithm>
+
+RectanglePacker::RectanglePacker(int width, int height)
+{
+	this->width = width;
+	this->height = height;
+	skyline.push_back({ 0, 0, width });
+}
+
+int RectanglePacker::GetFitY(int segment, int rectWidth, int rectHeight) const
+{
+	int x = skyline[segment].x;
+	if (x + rectWidth > width)
+	{
+		return -1;
+	}
+
+	// The rectangle rests on the highest segment under it
+	int y = 0;
+	int remainingWidth = rectWidth;
+	for (int i = segment; remainingWidth > 0; i++)
+	{
+		y = std::max(y, skyline[i].y);
+		if (y + rectHeight > height)
+		{
+			return -1;
+		}
+		remainingWidth -= skyline[i].width;
+	}
+
+	return y;
+}
+
+bool RectanglePacker::Pack(int rectWidth, int rectHeight, int& x, int& y)
+{
+	if (rectWidth <= 0 || rectHeight <= 0)
+	{
+		return false;
+	}
+
+	int bestSegment = -1;
+	int bestBottom = height + 1;
+	int bestWidth = width + 1;
+	for (int i = 0; i < static_cast<int>(skyline.size()); i++)
+	{
+		int fitY = GetFitY(i, rectWidth, rectHeight);
+		if (fitY < 0)
+		{
+			continue;
+		}
+
+		// Lowest bottom edge first, then the narrowest segment to keep the wide ones free
+		int bottom = fitY + rectHeight;
+		if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth))
+		{
+			bestSegment = i;
+			bestBottom = bottom;
+			bestWidth = skyline[i].width;
+			x = skyline[i].x;
+			y = fitY;
+		}
+	}
+
+	if (bestSegment < 0)
+	{
+		return false;
+	}
+
+	// The new segment covers the top of the rectangle; the segments under it are cut or removed
+	skyline.insert(skyline.begin() + bestSegment, { x, y + rectHeight, rectWidth });
+	for (std::size_t i = bestSegment + 1; i < skyline.size();)
+	{
+		int coveredEnd = x + rectWidth;
+		if (skyline[i].x >= coveredEnd)
+		{
+			break;
+		}
+
+		int overlap = coveredEnd - skyline[i].x;
+		if (overlap >= skyline[i].width)
+		{
+			skyline.erase(skyline.begin() + i);
+		}
+		else
+		{
+			skyline[i].x += overlap;
+			skyline[i].width -= overlap;
+			break;
+		}
+	}
+
+	// Merge the neighbour segments at the same height
+	for (std::size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,38 @@
+#ifndef RECTANGLE_PACKER_H
+#define RECTANGLE_PACKER_H
+
+#include <vector>
+
+/*---------------------------------------------------------------------------*/
+// RectanglePacker
+/*---------------------------------------------------------------------------*/
+// Places rectangles in a fixed size area with the skyline bottom-left rule:
+// the top edge of the packed rectangles is kept as a list of horizontal
+// segments, and each new rectangle goes where its bottom ends the highest
+// up, so that little space is left under it.
+/*---------------------------------------------------------------------------*/
+class RectanglePacker
+{
+private:
+	struct SkylineSegment
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	int width;
+	int height;
+	std::vector<SkylineSegment> skyline;
+
+	// Returns the y the rectangle would be placed at on the segment, or -1 if it does not fit there
+	int GetFitY(int segment, int rectWidth, int rectHeight) const;
+
+public:
+	RectanglePacker(int width, int height);
+
+	// Returns false if there is no room left for the rectangle
+	bool Pack(int rectWidth, int rectHeight, int& x, int& y);
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <algorithm>
+
+/*---------------------------------------------------------------------------*/
+// AABB
+/*---------------------------------------------------------------------------*/
+// Axis-aligned bounding box in world space, stored as min/max corners
+/*---------------------------------------------------------------------------*/
+struct AABB
+{
+	float minX;
+	float minY;
+	float maxX;
+	float maxY;
+
+	AABB(float minX = 0, float minY = 0, float maxX = 0, float maxY = 0)
+	{
+		this->minX = minX;
+		this->minY = minY;
+		this->maxX = maxX;
+		this->maxY = maxY;
+	}
+
+	float GetPerimeter() const
+	{
+		return 2.0f * ((maxX - minX) + (maxY - minY));
+	}
+
+	bool Contains(const AABB& other) const
+	{
+		return (
+			minX <= other.minX &&
+			minY <= other.minY &&
+			maxX >= other.maxX &&
+			maxY >= other.maxY
+		);
+	}
+
+	// Returns the box grown by the given margin on every side
+	AABB Expanded(float margin) const
+	{
+		return AABB(minX - margin, minY - margin, maxX + margin, maxY + margin);
+	}
+
+	// Returns the smallest box that encloses both boxes
+	static AABB Union(const AABB& a, const AABB& b)
+	{
+		return AABB(
+			std::min(a.minX, b.minX),
+			std::min(a.minY, b.minY),
+			std::max(a.maxX, b.maxX),
+			std::max(a.maxY, b.maxY)
+		);
+	}
+
+	// Boxes that only touch at their edges are not considered overlapping
+	bool Overlaps(const AABB& other) const
+	{
+		return (
+			minX < other.maxX &&
+			maxX > other.minX &&
+			minY < other.maxY &&
+			maxY > other.minY
+		);
+	}
+
+	// Slab test of the segment (x1, y1) -> (x2, y2) against the box.
+	// On a hit, entryFraction is where the segment enters the box, from 0 (start) to 1 (end).
+	bool IntersectsSegment(float x1, float y1, float x2, float y2, float& entryFraction) const
+	{
+		float tMin = 0.0f;
+		float tMax = 1.0f;
+		const float start[2] = { x1, y1 };
+		const float delta[2] = { x2 - x1, y2 - y1 };
+		const float boxMin[2] = { minX, minY };
+		const float boxMax[2] = { maxX, maxY };
+
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (delta[axis] == 0.0f)
+			{
+				// Parallel to this slab: it has to start inside of it
+				if (start[axis] < boxMin[axis] || start[axis] > boxMax[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			float inverseDelta = 1.0f / delta[axis];
+			float t1 = (boxMin[axis] - start[axis]) * inverseDelta;
+			float t2 = (boxMax[axis] - start[axis]) * inverseDelta;
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+
+			if (tMin > tMax)
+			{
+				return false;
+			}
+		}
+
+		entryFraction = tMin;
+		return true;
+	}
+};
+
+#endif
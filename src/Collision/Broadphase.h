@@ -0,0 +1,50 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "AABB.h"
+#include "CollisionLayers.h"
+#include <vector>
+
+// World-space collider box of one entity, as seen by the broadphase
+struct ColliderProxy
+{
+	int entityId;
+	AABB box;
+	unsigned int layer;
+	unsigned int mask;
+};
+
+// Pair of entity ids whose boxes may overlap (always stored with a < b)
+struct CollisionPair
+{
+	int a;
+	int b;
+
+	CollisionPair(int a = 0, int b = 0)
+	{
+		this->a = a < b ? a : b;
+		this->b = a < b ? b : a;
+	}
+
+	bool operator==(const CollisionPair& other) const { return a == other.a && b == other.b; }
+	bool operator<(const CollisionPair& other) const { return a < other.a || (a == other.a && b < other.b); }
+};
+
+/*---------------------------------------------------------------------------*/
+// Broadphase
+/*---------------------------------------------------------------------------*/
+// A broadphase culls the collider boxes down to a list of candidate pairs,
+// so only boxes that are close to each other reach the narrowphase AABB test.
+// Pairs whose layers can not collide are never reported. Candidate pairs may
+// contain duplicates and false positives.
+/*---------------------------------------------------------------------------*/
+class IBroadphase
+{
+public:
+	virtual ~IBroadphase() = default;
+
+	// Synchronize with this frame's collider boxes and append the candidate pairs
+	virtual void ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs) = 0;
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef COLLISION_DISPATCHER_H
+#define COLLISION_DISPATCHER_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/CollisionEnterEvent.h"
+#include <vector>
+
+template <typename TCallback> struct CollisionCallbackTraits;
+
+template <typename TOwner>
+struct CollisionCallbackTraits<void(TOwner::*)(Entity, Entity)>
+{
+	typedef TOwner Owner;
+};
+
+// Handler for the contacts between an entity of group a and an entity of group b, called as handler(a, b)
+struct CollisionHandler
+{
+	EventDelegate delegate;
+	int batchIndex;
+	bool swapped;
+
+	// Calls a handler(Entity, Entity) member function with the entities of each contact
+	template <auto Callback>
+	static void Invoke(void* ownerInstance, void* events, std::size_t count)
+	{
+		auto owner = static_cast<typename CollisionCallbackTraits<decltype(Callback)>::Owner*>(ownerInstance);
+		auto contacts = static_cast<CollisionEnterEvent*>(events);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			(owner->*Callback)(contacts[i].a, contacts[i].b);
+		}
+	}
+};
+
+// Handler called once per flush with all the contacts of its group pair, as events with a in the first group
+struct CollisionBatchHandler
+{
+	EventDelegate delegate;
+	std::vector<CollisionEnterEvent> events;
+};
+
+/*---------------------------------------------------------------------------*/
+// CollisionDispatcher
+/*---------------------------------------------------------------------------*/
+// Routes each new contact to the handlers registered for the groups of its
+// two entities, with the entities in the order the handler was registered
+// with. The handlers are found by indexing a table with the two group ids,
+// so contacts between groups nobody handles cost one lookup. Batch handlers
+// have their contacts queued instead, and get all of them at the flush.
+/*---------------------------------------------------------------------------*/
+class CollisionDispatcher
+{
+private:
+	int numGroups = 0;
+
+	// [Vector index = groupIdA * numGroups + groupIdB]
+	std::vector<std::vector<CollisionHandler>> handlersPerGroupPair;
+	std::vector<CollisionBatchHandler> batchHandlers;
+
+	void Grow(int groupId)
+	{
+		if (groupId < numGroups)
+		{
+			return;
+		}
+
+		int newNumGroups = groupId + 1;
+		std::vector<std::vector<CollisionHandler>> newHandlers(newNumGroups * newNumGroups);
+		for (int a = 0; a < numGroups; a++)
+		{
+			for (int b = 0; b < numGroups; b++)
+			{
+				newHandlers[a * newNumGroups + b] = std::move(handlersPerGroupPair[a * numGroups + b]);
+			}
+		}
+
+		handlersPerGroupPair = std::move(newHandlers);
+		numGroups = newNumGroups;
+	}
+
+	// Stored for both orders, so a contact finds its handlers with the order it comes in
+	void AddToGroupPair(int groupIdA, int groupIdB, CollisionHandler handler)
+	{
+		handlersPerGroupPair[groupIdA * numGroups + groupIdB].push_back(handler);
+		if (groupIdA != groupIdB)
+		{
+			handler.swapped = true;
+			handlersPerGroupPair[groupIdB * numGroups + groupIdA].push_back(handler);
+		}
+	}
+
+public:
+	// Example: dispatcher.AddHandler<&DamageSystem::OnProjectileHitsEnemy>(projectilesGroupId, enemiesGroupId, this);
+	template <auto Callback>
+	void AddHandler(int groupIdA, int groupIdB, typename CollisionCallbackTraits<decltype(Callback)>::Owner* ownerInstance)
+	{
+		Grow(groupIdA > groupIdB ? groupIdA : groupIdB);
+
+		EventDelegate delegate = { ownerInstance, &CollisionHandler::Invoke<Callback>, -1 };
+		AddToGroupPair(groupIdA, groupIdB, { delegate, -1, false });
+	}
+
+	// Example: dispatcher.AddBatchHandler<&DamageSystem::OnProjectilesHitEnemies>(projectilesGroupId, enemiesGroupId, this);
+	template <auto Callback>
+	void AddBatchHandler(int groupIdA, int groupIdB, typename MemberCallbackTraits<decltype(Callback)>::Owner* ownerInstance)
+	{
+		static_assert(MemberCallbackTraits<decltype(Callback)>::isBatch, "Batch collision handlers take an EventSpan<CollisionEnterEvent>");
+		Grow(groupIdA > groupIdB ? groupIdA : groupIdB);
+
+		EventDelegate delegate = { ownerInstance, &EventDelegate::Invoke<Callback>, -1 };
+		batchHandlers.push_back({ delegate, {} });
+		AddToGroupPair(groupIdA, groupIdB, { { nullptr, nullptr, -1 }, static_cast<int>(batchHandlers.size()) - 1, false });
+	}
+
+	void Clear()
+	{
+		numGroups = 0;
+		handlersPerGroupPair.clear();
+		batchHandlers.clear();
+	}
+
+	void Dispatch(Entity a, Entity b)
+	{
+		int groupIdA = a.GetGroupId();
+		int groupIdB = b.GetGroupId();
+		if (groupIdA < 0 || groupIdB < 0 || groupIdA >= numGroups || groupIdB >= numGroups)
+		{
+			return;
+		}
+
+		for (const auto& handler : handlersPerGroupPair[groupIdA * numGroups + groupIdB])
+		{
+			if (handler.batchIndex >= 0)
+			{
+				auto& events = batchHandlers[handler.batchIndex].events;
+				if (handler.swapped)
+				{
+					events.emplace_back(b, a);
+				}
+				else
+				{
+					events.emplace_back(a, b);
+				}
+			}
+			else
+			{
+				CollisionEnterEvent contact = handler.swapped ? CollisionEnterEvent(b, a) : CollisionEnterEvent(a, b);
+				handler.delegate.function(handler.delegate.ownerInstance, &contact, 1);
+			}
+		}
+	}
+
+	// Calls the batch handlers with the contacts queued since the last flush, in the order they were dispatched
+	void Flush()
+	{
+		for (auto& batchHandler : batchHandlers)
+		{
+			if (!batchHandler.events.empty())
+			{
+				batchHandler.delegate.function(batchHandler.delegate.ownerInstance, batchHandler.events.data(), batchHandler.events.size());
+				batchHandler.events.clear();
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "CollisionLayers.h"
+#include "../Logger/Logger.h"
+
+std::unordered_map<std::string, unsigned int> CollisionLayers::layerPerName;
+std::vector<std::string> CollisionLayers::layerNames;
+unsigned int CollisionLayers::defaultMasks[MAX_COLLISION_LAYERS] = {
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL,
+	COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL, COLLISION_MASK_ALL
+};
+
+void CollisionLayers::Reset()
+{
+	layerPerName.clear();
+	layerNames.clear();
+	for (auto& mask : defaultMasks)
+	{
+		mask = COLLISION_MASK_ALL;
+	}
+}
+
+unsigned int CollisionLayers::RegisterLayer(const std::string& name)
+{
+	unsigned int layer = FindLayer(name);
+	if (layer != 0)
+	{
+		return layer;
+	}
+
+	if (layerNames.size() == MAX_COLLISION_LAYERS)
+	{
+		Logger::Err("Too many collision layers, " + name + " was not added and will not collide");
+		return 0;
+	}
+
+	unsigned int newLayer = 1u << layerNames.size();
+	layerPerName.emplace(name, newLayer);
+	layerNames.push_back(name);
+	Logger::Log("Collision layer " + name + " was added with index " + std::to_string(layerNames.size() - 1));
+
+	return newLayer;
+}
+
+unsigned int CollisionLayers::FindLayer(const std::string& name)
+{
+	auto layer = layerPerName.find(name);
+	return layer != layerPerName.end() ? layer->second : 0;
+}
+
+unsigned int CollisionLayers::GetNumLayers()
+{
+	return static_cast<unsigned int>(layerNames.size());
+}
+
+const std::string& CollisionLayers::GetLayerName(unsigned int index)
+{
+	return layerNames[index];
+}
+
+unsigned int CollisionLayers::GetLayerIndex(unsigned int layer)
+{
+	unsigned int index = 0;
+	while (index < MAX_COLLISION_LAYERS - 1 && !(layer & (1u << index)))
+	{
+		index++;
+	}
+	return index;
+}
+
+void CollisionLayers::SetDefaultMask(unsigned int layer, unsigned int mask)
+{
+	if (layer == 0)
+	{
+		return;
+	}
+	defaultMasks[GetLayerIndex(layer)] = mask;
+}
+
+unsigned int CollisionLayers::GetDefaultMask(unsigned int layer)
+{
+	return layer != 0 ? defaultMasks[GetLayerIndex(layer)] : 0;
+}
@@ -0,0 +1,53 @@
+#ifndef COLLISION_LAYERS_H
+#define COLLISION_LAYERS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const unsigned int MAX_COLLISION_LAYERS = 32;
+const unsigned int COLLISION_MASK_ALL = 0xffffffff;
+
+/*---------------------------------------------------------------------------*/
+// CollisionLayers
+/*---------------------------------------------------------------------------*/
+// Every collider belongs to one layer (a single bit) and has a mask with the
+// layers it can collide with. Layers are referenced by name in the level
+// scripts; the level loader registers them, giving each name the next free
+// bit, and everything else only looks them up.
+/*---------------------------------------------------------------------------*/
+class CollisionLayers
+{
+private:
+	static std::unordered_map<std::string, unsigned int> layerPerName;
+	static std::vector<std::string> layerNames;
+	static unsigned int defaultMasks[MAX_COLLISION_LAYERS];
+
+	static unsigned int GetLayerIndex(unsigned int layer);
+
+public:
+	// Forgets all the layers and their default masks, before loading a level
+	static void Reset();
+
+	// Returns the bit of the named layer, adding it if it is new, or 0 if all the layers are taken
+	static unsigned int RegisterLayer(const std::string& name);
+
+	// Returns the bit of the named layer, or 0 if no layer has that name
+	static unsigned int FindLayer(const std::string& name);
+
+	// Layers in the order of their bits
+	static unsigned int GetNumLayers();
+	static const std::string& GetLayerName(unsigned int index);
+
+	// Mask used by the colliders of a layer that do not define their own
+	static void SetDefaultMask(unsigned int layer, unsigned int mask);
+	static unsigned int GetDefaultMask(unsigned int layer);
+};
+
+// Two colliders can only interact if each one's layer is in the mask of the other
+inline bool CanCollide(unsigned int layerA, unsigned int maskA, unsigned int layerB, unsigned int maskB)
+{
+	return (layerA & maskB) != 0 && (layerB & maskA) != 0;
+}
+
+#endif
@@ -0,0 +1,381 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+DynamicAABBTree::DynamicAABBTree(float margin)
+{
+	this->margin = margin;
+	Clear();
+}
+
+void DynamicAABBTree::Clear()
+{
+	nodes.clear();
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+}
+
+void DynamicAABBTree::SetMargin(float margin)
+{
+	this->margin = margin;
+}
+
+float DynamicAABBTree::GetMargin() const
+{
+	return margin;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+	int nodeId;
+
+	if (freeList != NULL_NODE)
+	{
+		// Reuse a node that was previously freed
+		nodeId = freeList;
+		freeList = nodes[nodeId].parent;
+	}
+	else
+	{
+		nodeId = static_cast<int>(nodes.size());
+		nodes.emplace_back();
+	}
+
+	TreeNode& node = nodes[nodeId];
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+	node.entityId = -1;
+
+	return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int nodeId)
+{
+	nodes[nodeId].parent = freeList;
+	nodes[nodeId].height = -1;
+	freeList = nodeId;
+}
+
+int DynamicAABBTree::CreateProxy(const AABB& box, int entityId)
+{
+	int proxyId = AllocateNode();
+
+	nodes[proxyId].box = box.Expanded(margin);
+	nodes[proxyId].tightBox = box;
+	nodes[proxyId].entityId = entityId;
+
+	InsertLeaf(proxyId);
+
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxyId)
+{
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+}
+
+bool DynamicAABBTree::MoveProxy(int proxyId, const AABB& box)
+{
+	nodes[proxyId].tightBox = box;
+
+	// Nothing to do while the collider is still inside of its fat box
+	if (nodes[proxyId].box.Contains(box))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+	nodes[proxyId].box = box.Expanded(margin);
+	InsertLeaf(proxyId);
+
+	return true;
+}
+
+const AABB& DynamicAABBTree::GetFatBox(int proxyId) const
+{
+	return nodes[proxyId].box;
+}
+
+const AABB& DynamicAABBTree::GetTightBox(int proxyId) const
+{
+	return nodes[proxyId].tightBox;
+}
+
+int DynamicAABBTree::GetEntityId(int proxyId) const
+{
+	return nodes[proxyId].entityId;
+}
+
+int DynamicAABBTree::GetHeight() const
+{
+	return root == NULL_NODE ? 0 : nodes[root].height;
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Descend the tree looking for the best sibling, using the perimeter as the cost of a box
+	AABB leafBox = nodes[leaf].box;
+	int index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		float perimeter = nodes[index].box.GetPerimeter();
+		float combinedPerimeter = AABB::Union(nodes[index].box, leafBox).GetPerimeter();
+
+		// Cost of creating a new parent for this node and the new leaf
+		float cost = 2.0f * combinedPerimeter;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+		auto descendCost = [&](int child) {
+			float unionPerimeter = AABB::Union(leafBox, nodes[child].box).GetPerimeter();
+			if (nodes[child].IsLeaf())
+			{
+				return unionPerimeter + inheritanceCost;
+			}
+			return (unionPerimeter - nodes[child].box.GetPerimeter()) + inheritanceCost;
+		};
+
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].box = AABB::Union(leafBox, nodes[sibling].box);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (nodes[oldParent].child1 == sibling)
+		{
+			nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		root = newParent;
+	}
+
+	// Walk back up the tree fixing heights and boxes
+	index = nodes[leaf].parent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].box = AABB::Union(nodes[child1].box, nodes[child2].box);
+
+		index = nodes[index].parent;
+	}
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent != NULL_NODE)
+	{
+		// Destroy the parent and connect the sibling to the grand parent
+		if (nodes[grandParent].child1 == parent)
+		{
+			nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			nodes[grandParent].child2 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		// Adjust the ancestor boxes and heights
+		int index = grandParent;
+		while (index != NULL_NODE)
+		{
+			index = Balance(index);
+
+			int child1 = nodes[index].child1;
+			int child2 = nodes[index].child2;
+			nodes[index].box = AABB::Union(nodes[child1].box, nodes[child2].box);
+			nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+			index = nodes[index].parent;
+		}
+	}
+	else
+	{
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		FreeNode(parent);
+	}
+}
+
+// Performs a left or right rotation if node A is imbalanced, and returns the new subtree root
+int DynamicAABBTree::Balance(int iA)
+{
+	TreeNode& A = nodes[iA];
+	if (A.IsLeaf() || A.height < 2)
+	{
+		return iA;
+	}
+
+	int iB = A.child1;
+	int iC = A.child2;
+	TreeNode& B = nodes[iB];
+	TreeNode& C = nodes[iC];
+
+	int balance = C.height - B.height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		int iF = C.child1;
+		int iG = C.child2;
+		TreeNode& F = nodes[iF];
+		TreeNode& G = nodes[iG];
+
+		// Swap A and C
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C
+		if (C.parent != NULL_NODE)
+		{
+			if (nodes[C.parent].child1 == iA)
+			{
+				nodes[C.parent].child1 = iC;
+			}
+			else
+			{
+				nodes[C.parent].child2 = iC;
+			}
+		}
+		else
+		{
+			root = iC;
+		}
+
+		// Rotate
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.box = AABB::Union(B.box, G.box);
+			C.box = AABB::Union(A.box, F.box);
+			A.height = 1 + std::max(B.height, G.height);
+			C.height = 1 + std::max(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.box = AABB::Union(B.box, F.box);
+			C.box = AABB::Union(A.box, G.box);
+			A.height = 1 + std::max(B.height, F.height);
+			C.height = 1 + std::max(A.height, G.height);
+		}
+
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		int iD = B.child1;
+		int iE = B.child2;
+		TreeNode& D = nodes[iD];
+		TreeNode& E = nodes[iE];
+
+		// Swap A and B
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B
+		if (B.parent != NULL_NODE)
+		{
+			if (nodes[B.parent].child1 == iA)
+			{
+				nodes[B.parent].child1 = iB;
+			}
+			else
+			{
+				nodes[B.parent].child2 = iB;
+			}
+		}
+		else
+		{
+			root = iB;
+		}
+
+		// Rotate
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.box = AABB::Union(C.box, E.box);
+			B.box = AABB::Union(A.box, D.box);
+			A.height = 1 + std::max(C.height, E.height);
+			B.height = 1 + std::max(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.box = AABB::Union(C.box, D.box);
+			B.box = AABB::Union(A.box, E.box);
+			A.height = 1 + std::max(C.height, D.height);
+			B.height = 1 + std::max(A.height, E.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
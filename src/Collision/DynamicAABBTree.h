@@ -0,0 +1,169 @@
+#ifndef DYNAMIC_AABB_TREE_H
+#define DYNAMIC_AABB_TREE_H
+
+#include "AABB.h"
+#include <vector>
+
+const int NULL_NODE = -1;
+
+struct TreeNode
+{
+	// Enlarged ("fat") box; for leaves it contains the tight box with some margin
+	AABB box;
+
+	// Exact collider box, only meaningful for leaves
+	AABB tightBox;
+
+	// Parent node while allocated, next free node while in the free list
+	int parent;
+	int child1;
+	int child2;
+
+	// Leaves have height 0, free nodes have height -1
+	int height;
+
+	int entityId;
+
+	bool IsLeaf() const
+	{
+		return child1 == NULL_NODE;
+	}
+};
+
+/*---------------------------------------------------------------------------*/
+// DynamicAABBTree
+/*---------------------------------------------------------------------------*/
+// Bounding volume hierarchy where each leaf is a proxy for one collider.
+// Leaves store a fat box, so a collider that moves a little stays inside of
+// its fat box and the tree does not need to change at all. Only colliders
+// that leave their fat box are removed and re-inserted, and the tree is kept
+// balanced with rotations as it is updated.
+/*---------------------------------------------------------------------------*/
+class DynamicAABBTree
+{
+private:
+	std::vector<TreeNode> nodes;
+	int root;
+	int freeList;
+	float margin;
+
+	// Stack reused by the tree traversals
+	mutable std::vector<int> stack;
+
+	int AllocateNode();
+	void FreeNode(int nodeId);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	int Balance(int nodeId);
+
+public:
+	DynamicAABBTree(float margin = 8.0f);
+	~DynamicAABBTree() = default;
+
+	void Clear();
+	void SetMargin(float margin);
+	float GetMargin() const;
+
+	// Proxy management (the proxy id is the leaf node index)
+	int CreateProxy(const AABB& box, int entityId);
+	void DestroyProxy(int proxyId);
+	// Returns true if the proxy left its fat box and had to be re-inserted
+	bool MoveProxy(int proxyId, const AABB& box);
+
+	const AABB& GetFatBox(int proxyId) const;
+	const AABB& GetTightBox(int proxyId) const;
+	int GetEntityId(int proxyId) const;
+	int GetHeight() const;
+
+	// Calls callback(proxyId) for every leaf whose fat box overlaps the box;
+	// the traversal stops early when the callback returns false
+	template <typename TCallback> void QueryFatBoxes(const AABB& box, TCallback&& callback) const;
+
+	// Calls callback(entityId) for every collider whose box overlaps the box
+	template <typename TCallback> void Query(const AABB& box, TCallback&& callback) const;
+
+	// Calls callback(entityId, entryFraction) for every collider hit by the segment (x1, y1) -> (x2, y2)
+	template <typename TCallback> void RayCast(float x1, float y1, float x2, float y2, TCallback&& callback) const;
+};
+
+template <typename TCallback>
+void DynamicAABBTree::QueryFatBoxes(const AABB& box, TCallback&& callback) const
+{
+	if (root == NULL_NODE)
+	{
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		int nodeId = stack.back();
+		stack.pop_back();
+
+		const TreeNode& node = nodes[nodeId];
+		if (!node.box.Overlaps(box))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			if (!callback(nodeId))
+			{
+				return;
+			}
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+template <typename TCallback>
+void DynamicAABBTree::Query(const AABB& box, TCallback&& callback) const
+{
+	QueryFatBoxes(box, [&](int proxyId) {
+		const TreeNode& leaf = nodes[proxyId];
+		return leaf.tightBox.Overlaps(box) ? callback(leaf.entityId) : true;
+	});
+}
+
+template <typename TCallback>
+void DynamicAABBTree::RayCast(float x1, float y1, float x2, float y2, TCallback&& callback) const
+{
+	if (root == NULL_NODE)
+	{
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		int nodeId = stack.back();
+		stack.pop_back();
+
+		const TreeNode& node = nodes[nodeId];
+		float entryFraction;
+
+		if (node.IsLeaf())
+		{
+			if (node.tightBox.IntersectsSegment(x1, y1, x2, y2, entryFraction) && !callback(node.entityId, entryFraction))
+			{
+				return;
+			}
+		}
+		else if (node.box.IntersectsSegment(x1, y1, x2, y2, entryFraction))
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "DynamicTreeBroadphase.h"
+#include <algorithm>
+
+DynamicTreeBroadphase::DynamicTreeBroadphase(float margin): tree(margin)
+{
+}
+
+const DynamicAABBTree& DynamicTreeBroadphase::GetTree() const
+{
+	return tree;
+}
+
+void DynamicTreeBroadphase::Synchronize(const std::vector<ColliderProxy>& proxies)
+{
+	movedEntities.clear();
+
+	for (const auto& proxy : proxies)
+	{
+		int entityId = proxy.entityId;
+
+		if (entityId >= static_cast<int>(proxyPerEntity.size()))
+		{
+			proxyPerEntity.resize(entityId + 1, NULL_NODE);
+			seen.resize(entityId + 1, false);
+			moved.resize(entityId + 1, false);
+			layers.resize(entityId + 1, 0);
+			masks.resize(entityId + 1, 0);
+		}
+
+		seen[entityId] = true;
+
+		// A collider whose layers changed has its pairs filtered again, as if it moved
+		bool layersChanged = layers[entityId] != proxy.layer || masks[entityId] != proxy.mask;
+		layers[entityId] = proxy.layer;
+		masks[entityId] = proxy.mask;
+
+		if (proxyPerEntity[entityId] == NULL_NODE)
+		{
+			// New collider
+			proxyPerEntity[entityId] = tree.CreateProxy(proxy.box, entityId);
+			entitiesWithProxy.push_back(entityId);
+			movedEntities.push_back(entityId);
+		}
+		else if (tree.MoveProxy(proxyPerEntity[entityId], proxy.box) || layersChanged)
+		{
+			movedEntities.push_back(entityId);
+		}
+	}
+
+	// Destroy the proxies of the colliders that are gone; their pairs are purged as if they moved
+	for (auto i = entitiesWithProxy.begin(); i != entitiesWithProxy.end();)
+	{
+		int entityId = *i;
+
+		if (seen[entityId])
+		{
+			seen[entityId] = false;
+			i++;
+			continue;
+		}
+
+		tree.DestroyProxy(proxyPerEntity[entityId]);
+		proxyPerEntity[entityId] = NULL_NODE;
+		movedEntities.push_back(entityId);
+
+		*i = entitiesWithProxy.back();
+		entitiesWithProxy.pop_back();
+	}
+}
+
+void DynamicTreeBroadphase::UpdatePairCache()
+{
+	if (movedEntities.empty())
+	{
+		return;
+	}
+
+	for (int entityId : movedEntities)
+	{
+		moved[entityId] = true;
+	}
+
+	// Drop every cached pair involving a collider that moved or disappeared
+	pairCache.erase(std::remove_if(pairCache.begin(), pairCache.end(), [this](const CollisionPair& pair) {
+		return moved[pair.a] || moved[pair.b];
+		}), pairCache.end());
+
+	// Query the tree again with the new fat box of the colliders that moved
+	newPairs.clear();
+	for (int entityId : movedEntities)
+	{
+		int proxyId = proxyPerEntity[entityId];
+		if (proxyId == NULL_NODE)
+		{
+			continue;
+		}
+
+		tree.QueryFatBoxes(tree.GetFatBox(proxyId), [&](int otherProxyId) {
+			int otherEntityId = tree.GetEntityId(otherProxyId);
+
+			if (!CanCollide(layers[entityId], masks[entityId], layers[otherEntityId], masks[otherEntityId]))
+			{
+				return true;
+			}
+
+			// When both colliders moved, the pair is found twice; keep it once
+			if (otherEntityId != entityId && (!moved[otherEntityId] || otherEntityId > entityId))
+			{
+				newPairs.emplace_back(entityId, otherEntityId);
+			}
+			return true;
+		});
+	}
+
+	for (int entityId : movedEntities)
+	{
+		moved[entityId] = false;
+	}
+
+	// Merge the new pairs into the sorted cache
+	std::sort(newPairs.begin(), newPairs.end());
+	auto middle = pairCache.insert(pairCache.end(), newPairs.begin(), newPairs.end());
+	std::inplace_merge(pairCache.begin(), middle, pairCache.end());
+}
+
+void DynamicTreeBroadphase::ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs)
+{
+	Synchronize(proxies);
+	UpdatePairCache();
+
+	pairs.insert(pairs.end(), pairCache.begin(), pairCache.end());
+}
@@ -0,0 +1,49 @@
+#ifndef DYNAMIC_TREE_BROADPHASE_H
+#define DYNAMIC_TREE_BROADPHASE_H
+
+#include "Broadphase.h"
+#include "DynamicAABBTree.h"
+#include <vector>
+
+/*---------------------------------------------------------------------------*/
+// DynamicTreeBroadphase
+/*---------------------------------------------------------------------------*/
+// Broadphase backed by a dynamic AABB tree, suited for levels that mix big
+// colliders with small ones. It keeps the pairs of overlapping fat boxes
+// from one frame to the next, so only the colliders that left their fat box
+// are queried again; colliders that barely move cost a box containment test.
+/*---------------------------------------------------------------------------*/
+class DynamicTreeBroadphase : public IBroadphase
+{
+private:
+	DynamicAABBTree tree;
+
+	// [Vector index = entity id]
+	// [Vector value = tree proxy id, or NULL_NODE]
+	std::vector<int> proxyPerEntity;
+	std::vector<int> entitiesWithProxy;
+	std::vector<bool> seen;
+	std::vector<unsigned int> layers;
+	std::vector<unsigned int> masks;
+
+	// Entities whose fat box changed this frame
+	std::vector<int> movedEntities;
+	std::vector<bool> moved;
+
+	// Pairs of overlapping fat boxes, kept sorted across frames
+	std::vector<CollisionPair> pairCache;
+	std::vector<CollisionPair> newPairs;
+
+	void Synchronize(const std::vector<ColliderProxy>& proxies);
+	void UpdatePairCache();
+
+public:
+	DynamicTreeBroadphase(float margin = 8.0f);
+	~DynamicTreeBroadphase() override = default;
+
+	const DynamicAABBTree& GetTree() const;
+
+	void ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs) override;
+};
+
+#endif
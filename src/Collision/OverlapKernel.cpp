@@ -0,0 +1,299 @@
+#include "OverlapKernel.h"
+#include "../Logger/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OVERLAP_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+void AABBArrays::Clear()
+{
+	minX.clear();
+	minY.clear();
+	maxX.clear();
+	maxY.clear();
+}
+
+void AABBArrays::Add(const AABB& box)
+{
+	minX.push_back(box.minX);
+	minY.push_back(box.minY);
+	maxX.push_back(box.maxX);
+	maxY.push_back(box.maxY);
+}
+
+int AABBArrays::Size() const
+{
+	return static_cast<int>(minX.size());
+}
+
+/*---------------------------------------------------------------------------*/
+// Kernels
+/*---------------------------------------------------------------------------*/
+// Every kernel clears the mask and handles the boxes that do not fill a
+// whole register with the scalar loop.
+/*---------------------------------------------------------------------------*/
+static void ClearMask(int count, uint32_t* hitMask)
+{
+	for (int word = 0; word < (count + 31) / 32; word++)
+	{
+		hitMask[word] = 0;
+	}
+}
+
+static void OverlapScalarRange(const AABB& box, const AABBArrays& boxes, int first, int last, uint32_t* hitMask)
+{
+	for (int i = first; i < last; i++)
+	{
+		bool hit =
+			box.minX < boxes.maxX[i] &&
+			box.maxX > boxes.minX[i] &&
+			box.minY < boxes.maxY[i] &&
+			box.maxY > boxes.minY[i];
+
+		hitMask[i >> 5] |= static_cast<uint32_t>(hit) << (i & 31);
+	}
+}
+
+static void OverlapScalar(const AABB& box, const AABBArrays& boxes, uint32_t* hitMask)
+{
+	int count = boxes.Size();
+	ClearMask(count, hitMask);
+	OverlapScalarRange(box, boxes, 0, count, hitMask);
+}
+
+#ifdef OVERLAP_KERNEL_X86
+static void OverlapSSE2(const AABB& box, const AABBArrays& boxes, uint32_t* hitMask)
+{
+	int count = boxes.Size();
+	ClearMask(count, hitMask);
+
+	const __m128 boxMinX = _mm_set1_ps(box.minX);
+	const __m128 boxMinY = _mm_set1_ps(box.minY);
+	const __m128 boxMaxX = _mm_set1_ps(box.maxX);
+	const __m128 boxMaxY = _mm_set1_ps(box.maxY);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 overlapX = _mm_and_ps(
+			_mm_cmplt_ps(boxMinX, _mm_loadu_ps(&boxes.maxX[i])),
+			_mm_cmpgt_ps(boxMaxX, _mm_loadu_ps(&boxes.minX[i])));
+		__m128 overlapY = _mm_and_ps(
+			_mm_cmplt_ps(boxMinY, _mm_loadu_ps(&boxes.maxY[i])),
+			_mm_cmpgt_ps(boxMaxY, _mm_loadu_ps(&boxes.minY[i])));
+
+		uint32_t bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(overlapX, overlapY)));
+		hitMask[i >> 5] |= bits << (i & 31);
+	}
+
+	OverlapScalarRange(box, boxes, i, count, hitMask);
+}
+
+TARGET_AVX2 static void OverlapAVX2(const AABB& box, const AABBArrays& boxes, uint32_t* hitMask)
+{
+	int count = boxes.Size();
+	ClearMask(count, hitMask);
+
+	const __m256 boxMinX = _mm256_set1_ps(box.minX);
+	const __m256 boxMinY = _mm256_set1_ps(box.minY);
+	const __m256 boxMaxX = _mm256_set1_ps(box.maxX);
+	const __m256 boxMaxY = _mm256_set1_ps(box.maxY);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 overlapX = _mm256_and_ps(
+			_mm256_cmp_ps(boxMinX, _mm256_loadu_ps(&boxes.maxX[i]), _CMP_LT_OQ),
+			_mm256_cmp_ps(boxMaxX, _mm256_loadu_ps(&boxes.minX[i]), _CMP_GT_OQ));
+		__m256 overlapY = _mm256_and_ps(
+			_mm256_cmp_ps(boxMinY, _mm256_loadu_ps(&boxes.maxY[i]), _CMP_LT_OQ),
+			_mm256_cmp_ps(boxMaxY, _mm256_loadu_ps(&boxes.minY[i]), _CMP_GT_OQ));
+
+		uint32_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(overlapX, overlapY)));
+		hitMask[i >> 5] |= bits << (i & 31);
+	}
+
+	OverlapScalarRange(box, boxes, i, count, hitMask);
+}
+
+TARGET_AVX512 static void OverlapAVX512(const AABB& box, const AABBArrays& boxes, uint32_t* hitMask)
+{
+	int count = boxes.Size();
+	ClearMask(count, hitMask);
+
+	const __m512 boxMinX = _mm512_set1_ps(box.minX);
+	const __m512 boxMinY = _mm512_set1_ps(box.minY);
+	const __m512 boxMaxX = _mm512_set1_ps(box.maxX);
+	const __m512 boxMaxY = _mm512_set1_ps(box.maxY);
+
+	int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__mmask16 hits = _mm512_cmp_ps_mask(boxMinX, _mm512_loadu_ps(&boxes.maxX[i]), _CMP_LT_OQ);
+		hits = _mm512_mask_cmp_ps_mask(hits, boxMaxX, _mm512_loadu_ps(&boxes.minX[i]), _CMP_GT_OQ);
+		hits = _mm512_mask_cmp_ps_mask(hits, boxMinY, _mm512_loadu_ps(&boxes.maxY[i]), _CMP_LT_OQ);
+		hits = _mm512_mask_cmp_ps_mask(hits, boxMaxY, _mm512_loadu_ps(&boxes.minY[i]), _CMP_GT_OQ);
+
+		hitMask[i >> 5] |= static_cast<uint32_t>(hits) << (i & 31);
+	}
+
+	OverlapScalarRange(box, boxes, i, count, hitMask);
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+// Dispatch
+/*---------------------------------------------------------------------------*/
+SimdLevel OverlapKernel::level = OverlapKernel::DetectSimdLevel();
+OverlapKernelFunction OverlapKernel::kernel = OverlapKernel::GetKernel(OverlapKernel::level);
+
+SimdLevel OverlapKernel::DetectSimdLevel()
+{
+#if defined(OVERLAP_KERNEL_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool hasSSE2 = (info[3] & (1 << 26)) != 0;
+	bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+	unsigned long long enabledStates = hasOSXSAVE ? _xgetbv(0) : 0;
+
+	bool hasAVX2 = false;
+	bool hasAVX512 = false;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		// The OS must save the ymm (and for AVX-512, the zmm and mask) registers on context switches
+		hasAVX2 = (info[1] & (1 << 5)) != 0 && (enabledStates & 0x06) == 0x06;
+		hasAVX512 = (info[1] & (1 << 16)) != 0 && (enabledStates & 0xe6) == 0xe6;
+	}
+
+	if (hasAVX512) return SIMD_AVX512;
+	if (hasAVX2) return SIMD_AVX2;
+	if (hasSSE2) return SIMD_SSE2;
+	return SIMD_SCALAR;
+#elif defined(OVERLAP_KERNEL_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+	if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+	if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+	return SIMD_SCALAR;
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+bool OverlapKernel::IsSupported(SimdLevel level)
+{
+	return level <= DetectSimdLevel();
+}
+
+OverlapKernelFunction OverlapKernel::GetKernel(SimdLevel level)
+{
+	switch (level)
+	{
+#ifdef OVERLAP_KERNEL_X86
+		case SIMD_AVX512: return OverlapAVX512;
+		case SIMD_AVX2: return OverlapAVX2;
+		case SIMD_SSE2: return OverlapSSE2;
+#endif
+		default: return OverlapScalar;
+	}
+}
+
+void OverlapKernel::SetSimdLevel(SimdLevel level)
+{
+	if (!IsSupported(level))
+	{
+		Logger::Err("The " + std::string(simdLevelNames[level]) + " overlap kernel is not supported by this CPU");
+		return;
+	}
+
+	OverlapKernel::level = level;
+	kernel = GetKernel(level);
+	Logger::Log("Overlap kernel set to " + std::string(simdLevelNames[level]));
+}
+
+SimdLevel OverlapKernel::GetSimdLevel()
+{
+	return level;
+}
+
+void OverlapKernel::Benchmark(int numBoxes, int numRepeats)
+{
+	// Boxes of 8 to 40 pixels scattered over a 512 x 512 area, so about a tenth of them overlap
+	std::mt19937 random(12345);
+	std::uniform_real_distribution<float> position(0.0f, 512.0f);
+	std::uniform_real_distribution<float> size(8.0f, 40.0f);
+
+	AABBArrays boxes;
+	std::vector<AABB> queries;
+	for (int i = 0; i < numBoxes; i++)
+	{
+		float x = position(random);
+		float y = position(random);
+		boxes.Add(AABB(x, y, x + size(random), y + size(random)));
+	}
+	for (int i = 0; i < numRepeats; i++)
+	{
+		float x = position(random);
+		float y = position(random);
+		queries.emplace_back(x, y, x + size(random), y + size(random));
+	}
+
+	int numWords = (numBoxes + 31) / 32;
+	std::vector<uint32_t> expected(numWords * numRepeats);
+	std::vector<uint32_t> hitMask(numWords * numRepeats);
+	double scalarMilliseconds = 0.0;
+
+	for (int simdLevel = SIMD_SCALAR; simdLevel <= SIMD_AVX512; simdLevel++)
+	{
+		if (!IsSupported(static_cast<SimdLevel>(simdLevel)))
+		{
+			continue;
+		}
+
+		OverlapKernelFunction function = GetKernel(static_cast<SimdLevel>(simdLevel));
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < numRepeats; i++)
+		{
+			function(queries[i], boxes, &hitMask[i * numWords]);
+		}
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		if (simdLevel == SIMD_SCALAR)
+		{
+			expected = hitMask;
+			scalarMilliseconds = elapsed.count();
+		}
+
+		char result[128];
+		std::snprintf(result, sizeof(result), "Overlap kernel %s: %.3f ms for %d x %d tests (%.2fx scalar)%s",
+			simdLevelNames[simdLevel], elapsed.count(), numRepeats, numBoxes,
+			elapsed.count() > 0.0 ? scalarMilliseconds / elapsed.count() : 0.0,
+			hitMask == expected ? "" : ", MISMATCH");
+
+		if (hitMask == expected)
+		{
+			Logger::Log(result);
+		}
+		else
+		{
+			Logger::Err(result);
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef OVERLAP_KERNEL_H
+#define OVERLAP_KERNEL_H
+
+#include "AABB.h"
+#include <cstdint>
+#include <vector>
+
+enum SimdLevel
+{
+	SIMD_SCALAR,
+	SIMD_SSE2,
+	SIMD_AVX2,
+	SIMD_AVX512
+};
+
+static const char* const simdLevelNames[] = { "scalar", "sse2", "avx2", "avx512" };
+
+// Boxes stored as one array per coordinate (structure of arrays), so the kernels can load several at once
+struct AABBArrays
+{
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+
+	void Clear();
+	void Add(const AABB& box);
+	int Size() const;
+};
+
+// Writes bit i of hitMask when the box overlaps box i of the arrays; hitMask holds (count + 31) / 32 words
+typedef void (*OverlapKernelFunction)(const AABB& box, const AABBArrays& boxes, uint32_t* hitMask);
+
+/*---------------------------------------------------------------------------*/
+// OverlapKernel
+/*---------------------------------------------------------------------------*/
+// Tests one box against a batch of boxes, 4 (SSE2), 8 (AVX2) or 16 (AVX-512)
+// boxes per instruction, with the same strict comparisons as AABB::Overlaps.
+// The widest instruction set supported by the CPU is picked at startup.
+/*---------------------------------------------------------------------------*/
+class OverlapKernel
+{
+private:
+	static SimdLevel level;
+	static OverlapKernelFunction kernel;
+
+	static OverlapKernelFunction GetKernel(SimdLevel level);
+
+public:
+	static SimdLevel DetectSimdLevel();
+	static bool IsSupported(SimdLevel level);
+
+	static void SetSimdLevel(SimdLevel level);
+	static SimdLevel GetSimdLevel();
+
+	static void ComputeOverlapMask(const AABB& box, const AABBArrays& boxes, uint32_t* hitMask)
+	{
+		kernel(box, boxes, hitMask);
+	}
+
+	// Times every supported kernel on random boxes, checks them against the scalar one and logs the results
+	static void Benchmark(int numBoxes = 4096, int numRepeats = 256);
+};
+
+#endif
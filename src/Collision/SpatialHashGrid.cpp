@@ -0,0 +1,121 @@
+#include "SpatialHashGrid.h"
+#include <cmath>
+
+SpatialHashGrid::SpatialHashGrid(float cellSize)
+{
+	bucketMask = 0;
+	SetCellSize(cellSize);
+}
+
+void SpatialHashGrid::SetCellSize(float cellSize)
+{
+	this->cellSize = cellSize > 1.0f ? cellSize : 1.0f;
+	this->inverseCellSize = 1.0f / this->cellSize;
+}
+
+float SpatialHashGrid::GetCellSize() const
+{
+	return cellSize;
+}
+
+unsigned int SpatialHashGrid::HashCell(int cellX, int cellY) const
+{
+	return ((static_cast<unsigned int>(cellX) * 73856093u) ^ (static_cast<unsigned int>(cellY) * 19349663u)) & bucketMask;
+}
+
+int SpatialHashGrid::CellCoordinate(float position) const
+{
+	return static_cast<int>(std::floor(position * inverseCellSize));
+}
+
+void SpatialHashGrid::Rebuild(const std::vector<ColliderProxy>& proxies)
+{
+	// Use (at least) twice as many buckets as boxes, rounded up to a power of two
+	unsigned int numBuckets = 64;
+	while (numBuckets < proxies.size() * 2)
+	{
+		numBuckets *= 2;
+	}
+	bucketMask = numBuckets - 1;
+
+	bucketStart.assign(numBuckets + 1, 0);
+
+	// First pass: count how many entries fall in each bucket
+	int numEntries = 0;
+	for (const auto& proxy : proxies)
+	{
+		for (int y = CellCoordinate(proxy.box.minY); y <= CellCoordinate(proxy.box.maxY); y++)
+		{
+			for (int x = CellCoordinate(proxy.box.minX); x <= CellCoordinate(proxy.box.maxX); x++)
+			{
+				bucketStart[HashCell(x, y) + 1]++;
+				numEntries++;
+			}
+		}
+	}
+
+	// Turn the counts into start offsets
+	for (unsigned int b = 0; b < numBuckets; b++)
+	{
+		bucketStart[b + 1] += bucketStart[b];
+	}
+
+	// Second pass: scatter the proxy indexes into their bucket ranges
+	cellEntries.resize(numEntries);
+	std::vector<int>::size_type numProxies = proxies.size();
+	nextEntry.assign(bucketStart.begin(), bucketStart.end() - 1);
+	for (std::vector<int>::size_type i = 0; i < numProxies; i++)
+	{
+		const auto& box = proxies[i].box;
+		for (int y = CellCoordinate(box.minY); y <= CellCoordinate(box.maxY); y++)
+		{
+			for (int x = CellCoordinate(box.minX); x <= CellCoordinate(box.maxX); x++)
+			{
+				cellEntries[nextEntry[HashCell(x, y)]++] = static_cast<int>(i);
+			}
+		}
+	}
+}
+
+void SpatialHashGrid::ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs)
+{
+	Rebuild(proxies);
+
+	for (unsigned int b = 0; b <= bucketMask; b++)
+	{
+		int first = bucketStart[b];
+		int last = bucketStart[b + 1];
+
+		for (int i = first; i < last; i++)
+		{
+			const auto& proxyA = proxies[cellEntries[i]];
+
+			for (int j = i + 1; j < last; j++)
+			{
+				// A box covering two cells that hash to the same bucket appears twice in it
+				if (cellEntries[i] == cellEntries[j])
+				{
+					continue;
+				}
+
+				const auto& proxyB = proxies[cellEntries[j]];
+
+				if (!CanCollide(proxyA.layer, proxyA.mask, proxyB.layer, proxyB.mask))
+				{
+					continue;
+				}
+
+				// Boxes sharing several cells would be paired once per cell; only report the pair
+				// from the bucket of the cell holding the top-left corner of their intersection
+				int cellX = CellCoordinate(std::max(proxyA.box.minX, proxyB.box.minX));
+				int cellY = CellCoordinate(std::max(proxyA.box.minY, proxyB.box.minY));
+				if (HashCell(cellX, cellY) != b)
+				{
+					continue;
+				}
+
+				pairs.emplace_back(proxyA.entityId, proxyB.entityId);
+			}
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef SPATIAL_HASH_GRID_H
+#define SPATIAL_HASH_GRID_H
+
+#include "Broadphase.h"
+#include <vector>
+
+/*---------------------------------------------------------------------------*/
+// SpatialHashGrid
+/*---------------------------------------------------------------------------*/
+// Uniform grid broadphase. Every box is inserted in the cells it covers and
+// cells are hashed into a fixed number of buckets, so the grid has no bounds.
+// The buckets are rebuilt every frame with a counting sort, which keeps all
+// the entries of a bucket contiguous and avoids per-cell allocations.
+/*---------------------------------------------------------------------------*/
+class SpatialHashGrid : public IBroadphase
+{
+private:
+	float cellSize;
+	float inverseCellSize;
+	unsigned int bucketMask;
+
+	// Entries of bucket b are cellEntries[bucketStart[b]] .. cellEntries[bucketStart[b + 1] - 1]
+	// [Entry value = proxy index]
+	std::vector<int> bucketStart;
+	std::vector<int> cellEntries;
+	std::vector<int> nextEntry;
+
+	unsigned int HashCell(int cellX, int cellY) const;
+	int CellCoordinate(float position) const;
+	void Rebuild(const std::vector<ColliderProxy>& proxies);
+
+public:
+	SpatialHashGrid(float cellSize = 64.0f);
+	~SpatialHashGrid() override = default;
+
+	void SetCellSize(float cellSize);
+	float GetCellSize() const;
+
+	void ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs) override;
+};
+
+#endif
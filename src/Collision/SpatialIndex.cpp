@@ -0,0 +1,144 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+
+SpatialIndex::SpatialIndex(float margin): tree(margin)
+{
+}
+
+void SpatialIndex::Clear()
+{
+	tree.Clear();
+	proxyPerEntity.clear();
+	layerPerEntity.clear();
+}
+
+void SpatialIndex::SetBox(int entityId, const AABB& box, unsigned int layer)
+{
+	if (entityId >= static_cast<int>(proxyPerEntity.size()))
+	{
+		proxyPerEntity.resize(entityId + 1, NULL_NODE);
+		layerPerEntity.resize(entityId + 1, 0);
+	}
+
+	if (proxyPerEntity[entityId] == NULL_NODE)
+	{
+		proxyPerEntity[entityId] = tree.CreateProxy(box, entityId);
+	}
+	else
+	{
+		tree.MoveProxy(proxyPerEntity[entityId], box);
+	}
+	layerPerEntity[entityId] = layer;
+}
+
+void SpatialIndex::Remove(int entityId)
+{
+	if (entityId < static_cast<int>(proxyPerEntity.size()) && proxyPerEntity[entityId] != NULL_NODE)
+	{
+		tree.DestroyProxy(proxyPerEntity[entityId]);
+		proxyPerEntity[entityId] = NULL_NODE;
+	}
+}
+
+float SpatialIndex::GetDistanceSquared(const AABB& box, float x, float y)
+{
+	// Distance to the closest point of the box, 0 inside of it
+	float deltaX = std::max(std::max(box.minX - x, 0.0f), x - box.maxX);
+	float deltaY = std::max(std::max(box.minY - y, 0.0f), y - box.maxY);
+	return deltaX * deltaX + deltaY * deltaY;
+}
+
+int SpatialIndex::QueryRect(const AABB& box, unsigned int mask, std::vector<int>& results) const
+{
+	results.clear();
+	tree.Query(box, [&](int entityId) {
+		if (layerPerEntity[entityId] & mask)
+		{
+			results.push_back(entityId);
+		}
+		return true;
+	});
+
+	return static_cast<int>(results.size());
+}
+
+int SpatialIndex::QueryRadius(float x, float y, float radius, unsigned int mask, std::vector<int>& results) const
+{
+	results.clear();
+	AABB box(x - radius, y - radius, x + radius, y + radius);
+	tree.QueryFatBoxes(box, [&](int proxyId) {
+		int entityId = tree.GetEntityId(proxyId);
+		if ((layerPerEntity[entityId] & mask) && GetDistanceSquared(tree.GetTightBox(proxyId), x, y) <= radius * radius)
+		{
+			results.push_back(entityId);
+		}
+		return true;
+	});
+
+	return static_cast<int>(results.size());
+}
+
+int SpatialIndex::QueryNearest(float x, float y, int k, float maxDistance, unsigned int mask, std::vector<int>& results) const
+{
+	results.clear();
+	if (k <= 0 || maxDistance < 0.0f || mask == 0)
+	{
+		return 0;
+	}
+
+	// The search box grows until it holds k entities within its radius: the entities outside of it are farther away
+	float radius = std::min(64.0f, maxDistance);
+	while (true)
+	{
+		candidates.clear();
+		int numWithinRadius = 0;
+		AABB box(x - radius, y - radius, x + radius, y + radius);
+		tree.QueryFatBoxes(box, [&](int proxyId) {
+			int entityId = tree.GetEntityId(proxyId);
+			float distanceSquared = GetDistanceSquared(tree.GetTightBox(proxyId), x, y);
+			if ((layerPerEntity[entityId] & mask) && distanceSquared <= maxDistance * maxDistance)
+			{
+				candidates.emplace_back(distanceSquared, entityId);
+				numWithinRadius += distanceSquared <= radius * radius;
+			}
+			return true;
+		});
+
+		if (numWithinRadius >= k || radius >= maxDistance)
+		{
+			break;
+		}
+		radius = std::min(radius * 2.0f, maxDistance);
+	}
+
+	// Ties are broken by entity id, so the results do not depend on the shape of the tree
+	int numResults = std::min(k, static_cast<int>(candidates.size()));
+	std::partial_sort(candidates.begin(), candidates.begin() + numResults, candidates.end());
+	for (int i = 0; i < numResults; i++)
+	{
+		results.push_back(candidates[i].second);
+	}
+
+	return numResults;
+}
+
+int SpatialIndex::RayCast(float x1, float y1, float x2, float y2, unsigned int mask, std::vector<int>& results) const
+{
+	results.clear();
+	candidates.clear();
+	tree.RayCast(x1, y1, x2, y2, [&](int entityId, float entryFraction) {
+		if (layerPerEntity[entityId] & mask)
+		{
+			candidates.emplace_back(entryFraction, entityId);
+		}
+		return true;
+	});
+
+	std::sort(candidates.begin(), candidates.end());
+	for (const auto& candidate : candidates)
+	{
+		results.push_back(candidate.second);
+	}
+
+	return static_cast<int>(results.size());
+}
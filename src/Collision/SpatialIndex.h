@@ -0,0 +1,55 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "AABB.h"
+#include "CollisionLayers.h"
+#include "DynamicAABBTree.h"
+#include <utility>
+#include <vector>
+
+/*---------------------------------------------------------------------------*/
+// SpatialIndex
+/*---------------------------------------------------------------------------*/
+// The collider boxes of all the entities in a dynamic AABB tree, kept up to
+// date by the collision system, to answer the queries of the game code and
+// the level scripts: the entities in a rectangle or a radius, the k nearest
+// ones, and the ones hit by a ray. The queries fill a vector of entity ids
+// owned by the caller, and only return the colliders whose layer is in the
+// mask.
+/*---------------------------------------------------------------------------*/
+class SpatialIndex
+{
+private:
+	DynamicAABBTree tree;
+
+	// [Vector index = entity id]
+	std::vector<int> proxyPerEntity;
+	std::vector<unsigned int> layerPerEntity;
+
+	// Squared distances (or ray fractions) with their entity ids, reused by the sorted queries
+	mutable std::vector<std::pair<float, int>> candidates;
+
+	static float GetDistanceSquared(const AABB& box, float x, float y);
+
+public:
+	SpatialIndex(float margin = 8.0f);
+	~SpatialIndex() = default;
+
+	void Clear();
+
+	// Adds the entity, or moves its box
+	void SetBox(int entityId, const AABB& box, unsigned int layer);
+	void Remove(int entityId);
+
+	// The queries clear the results first, and return how many entities were found
+	int QueryRect(const AABB& box, unsigned int mask, std::vector<int>& results) const;
+	int QueryRadius(float x, float y, float radius, unsigned int mask, std::vector<int>& results) const;
+
+	// Up to k entities within maxDistance of the point, the nearest first
+	int QueryNearest(float x, float y, int k, float maxDistance, unsigned int mask, std::vector<int>& results) const;
+
+	// Entities hit by the segment (x1, y1) -> (x2, y2), in the order the segment enters them
+	int RayCast(float x1, float y1, float x2, float y2, unsigned int mask, std::vector<int>& results) const;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+// Endpoints are ordered by value; on ties the max endpoints go first,
+// so boxes that only touch at their edges do not overlap
+static bool EndpointLess(const Endpoint& a, const Endpoint& b)
+{
+	return a.value < b.value || (a.value == b.value && a.isMax && !b.isMax);
+}
+
+uint64_t SweepAndPrune::PairKey(int a, int b)
+{
+	CollisionPair pair(a, b);
+	return (static_cast<uint64_t>(pair.a) << 32) | static_cast<uint32_t>(pair.b);
+}
+
+void SweepAndPrune::AddPair(int a, int b)
+{
+	if (!CanCollide(layers[a], masks[a], layers[b], masks[b]))
+	{
+		return;
+	}
+
+	uint64_t key = PairKey(a, b);
+	auto pair = std::lower_bound(pairs.begin(), pairs.end(), key);
+	if (pair == pairs.end() || *pair != key)
+	{
+		pairs.insert(pair, key);
+	}
+}
+
+void SweepAndPrune::RemovePair(int a, int b)
+{
+	uint64_t key = PairKey(a, b);
+	auto pair = std::lower_bound(pairs.begin(), pairs.end(), key);
+	if (pair != pairs.end() && *pair == key)
+	{
+		pairs.erase(pair);
+	}
+}
+
+const std::vector<CollisionPair>& SweepAndPrune::GetAddedPairs() const
+{
+	return addedPairs;
+}
+
+const std::vector<CollisionPair>& SweepAndPrune::GetRemovedPairs() const
+{
+	return removedPairs;
+}
+
+// New boxes are appended at the end of the axes, and the insertion sort moves them into place
+void SweepAndPrune::AddEndpoints(int entityId)
+{
+	hasProxy[entityId] = true;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		axes[axis].push_back({ 0.0f, entityId, false });
+		axes[axis].push_back({ 0.0f, entityId, true });
+	}
+}
+
+void SweepAndPrune::Synchronize(const std::vector<ColliderProxy>& proxies)
+{
+	reinsertedEntities.clear();
+
+	for (const auto& proxy : proxies)
+	{
+		int entityId = proxy.entityId;
+
+		if (entityId >= static_cast<int>(boxes.size()))
+		{
+			boxes.resize(entityId + 1);
+			hasProxy.resize(entityId + 1, false);
+			seen.resize(entityId + 1, false);
+			layers.resize(entityId + 1, 0);
+			masks.resize(entityId + 1, 0);
+		}
+
+		boxes[entityId] = proxy.box;
+		seen[entityId] = true;
+
+		if (!hasProxy[entityId])
+		{
+			layers[entityId] = proxy.layer;
+			masks[entityId] = proxy.mask;
+			entitiesWithProxy.push_back(entityId);
+			AddEndpoints(entityId);
+		}
+		else if (layers[entityId] != proxy.layer || masks[entityId] != proxy.mask)
+		{
+			// Pairs are only filtered when the sort finds them, so a box whose layers
+			// changed is taken out and inserted again to filter its pairs with the new ones
+			layers[entityId] = proxy.layer;
+			masks[entityId] = proxy.mask;
+			reinsertedEntities.push_back(entityId);
+		}
+	}
+
+	// Remove the boxes of the colliders that are gone, along with their pairs
+	bool anyRemoved = false;
+	for (auto i = entitiesWithProxy.begin(); i != entitiesWithProxy.end();)
+	{
+		int entityId = *i;
+
+		if (seen[entityId])
+		{
+			seen[entityId] = false;
+			i++;
+			continue;
+		}
+
+		hasProxy[entityId] = false;
+		anyRemoved = true;
+
+		*i = entitiesWithProxy.back();
+		entitiesWithProxy.pop_back();
+	}
+
+	for (int entityId : reinsertedEntities)
+	{
+		hasProxy[entityId] = false;
+		anyRemoved = true;
+	}
+
+	if (anyRemoved)
+	{
+		for (auto& axis : axes)
+		{
+			axis.erase(std::remove_if(axis.begin(), axis.end(), [this](const Endpoint& endpoint) {
+				return !hasProxy[endpoint.entityId];
+				}), axis.end());
+		}
+
+		pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [this](uint64_t key) {
+			return !hasProxy[static_cast<int>(key >> 32)] || !hasProxy[static_cast<int>(key & 0xffffffff)];
+			}), pairs.end());
+	}
+
+	for (int entityId : reinsertedEntities)
+	{
+		AddEndpoints(entityId);
+	}
+
+	// Refresh the endpoint values with this frame's boxes
+	for (auto& endpoint : axes[0])
+	{
+		const AABB& box = boxes[endpoint.entityId];
+		endpoint.value = endpoint.isMax ? box.maxX : box.minX;
+	}
+	for (auto& endpoint : axes[1])
+	{
+		const AABB& box = boxes[endpoint.entityId];
+		endpoint.value = endpoint.isMax ? box.maxY : box.minY;
+	}
+}
+
+void SweepAndPrune::SortAxis(int axis)
+{
+	auto& endpoints = axes[axis];
+	int numEndpoints = static_cast<int>(endpoints.size());
+
+	for (int i = 1; i < numEndpoints; i++)
+	{
+		Endpoint key = endpoints[i];
+		int j = i - 1;
+
+		while (j >= 0 && EndpointLess(key, endpoints[j]))
+		{
+			const Endpoint& other = endpoints[j];
+
+			if (key.entityId == other.entityId)
+			{
+				// Endpoints of the same box (while a new box is moved into place)
+			}
+			else if (!key.isMax && other.isMax)
+			{
+				// A min endpoint moves before a max endpoint: the boxes start overlapping on this axis
+				if (boxes[key.entityId].Overlaps(boxes[other.entityId]))
+				{
+					AddPair(key.entityId, other.entityId);
+				}
+			}
+			else if (key.isMax && !other.isMax)
+			{
+				// A max endpoint moves before a min endpoint: the boxes stop overlapping on this axis
+				RemovePair(key.entityId, other.entityId);
+			}
+
+			endpoints[j + 1] = endpoints[j];
+			j--;
+		}
+
+		endpoints[j + 1] = key;
+	}
+}
+
+// One merge of the sorted pairs of the previous and of this update finds both deltas
+void SweepAndPrune::ComputePairDeltas()
+{
+	addedPairs.clear();
+	removedPairs.clear();
+
+	auto previous = previousPairs.begin();
+	auto current = pairs.begin();
+	while (previous != previousPairs.end() || current != pairs.end())
+	{
+		if (current == pairs.end() || (previous != previousPairs.end() && *previous < *current))
+		{
+			removedPairs.emplace_back(static_cast<int>(*previous >> 32), static_cast<int>(*previous & 0xffffffff));
+			previous++;
+		}
+		else if (previous == previousPairs.end() || *current < *previous)
+		{
+			addedPairs.emplace_back(static_cast<int>(*current >> 32), static_cast<int>(*current & 0xffffffff));
+			current++;
+		}
+		else
+		{
+			previous++;
+			current++;
+		}
+	}
+
+	previousPairs = pairs;
+}
+
+void SweepAndPrune::ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs)
+{
+	Synchronize(proxies);
+	SortAxis(0);
+	SortAxis(1);
+	ComputePairDeltas();
+
+	for (uint64_t key : this->pairs)
+	{
+		pairs.emplace_back(static_cast<int>(key >> 32), static_cast<int>(key & 0xffffffff));
+	}
+}
@@ -0,0 +1,69 @@
+#ifndef SWEEP_AND_PRUNE_H
+#define SWEEP_AND_PRUNE_H
+
+#include "Broadphase.h"
+#include <cstdint>
+#include <vector>
+
+struct Endpoint
+{
+	float value;
+	int entityId;
+	bool isMax;
+};
+
+/*---------------------------------------------------------------------------*/
+// SweepAndPrune
+/*---------------------------------------------------------------------------*/
+// Incremental sweep-and-prune broadphase. The box endpoints are kept sorted
+// along both axes across frames and re-sorted with an insertion sort, which
+// is close to O(n) when colliders move little between frames. Every swap of
+// two endpoints is a change of overlap on that axis, so the set of
+// overlapping pairs is updated from the swaps alone. The pairs that started
+// or stopped overlapping are kept for the callers that only want the changes.
+/*---------------------------------------------------------------------------*/
+class SweepAndPrune : public IBroadphase
+{
+private:
+	// Sorted endpoints for the x (0) and y (1) axes
+	std::vector<Endpoint> axes[2];
+
+	// [Vector index = entity id]
+	std::vector<AABB> boxes;
+	std::vector<bool> hasProxy;
+	std::vector<bool> seen;
+	std::vector<unsigned int> layers;
+	std::vector<unsigned int> masks;
+	std::vector<int> entitiesWithProxy;
+
+	// Entities whose layers changed, taken out of the axes and inserted again
+	std::vector<int> reinsertedEntities;
+
+	// Overlapping pairs, keyed by (a << 32 | b) and kept sorted; only a few change per frame
+	std::vector<uint64_t> pairs;
+	std::vector<uint64_t> previousPairs;
+
+	// Pairs that started or stopped overlapping in the last update
+	std::vector<CollisionPair> addedPairs;
+	std::vector<CollisionPair> removedPairs;
+
+	static uint64_t PairKey(int a, int b);
+	void AddPair(int a, int b);
+	void RemovePair(int a, int b);
+	void AddEndpoints(int entityId);
+	void Synchronize(const std::vector<ColliderProxy>& proxies);
+	void SortAxis(int axis);
+	void ComputePairDeltas();
+
+public:
+	SweepAndPrune() = default;
+	~SweepAndPrune() override = default;
+
+	// Sorted by entity ids, so a pair removed and added back within the same update is in neither
+	const std::vector<CollisionPair>& GetAddedPairs() const;
+	const std::vector<CollisionPair>& GetRemovedPairs() const;
+
+	void ComputePairs(const std::vector<ColliderProxy>& proxies, std::vector<CollisionPair>& pairs) override;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "TileCollisionGrid.h"
+#include <algorithm>
+#include <cmath>
+
+void TileCollisionGrid::Reset(int numCols, int numRows, float tileSize)
+{
+	this->numCols = numCols;
+	this->numRows = numRows;
+	this->tileSize = tileSize > 0.0f ? tileSize : 1.0f;
+	numSolidTiles = 0;
+	solidBits.assign((numCols * numRows + 63) / 64, 0);
+	layer = 0;
+	mask = 0;
+}
+
+void TileCollisionGrid::SetSolid(int col, int row, bool solid)
+{
+	if (col < 0 || row < 0 || col >= numCols || row >= numRows || IsSolid(col, row) == solid)
+	{
+		return;
+	}
+
+	int index = row * numCols + col;
+	solidBits[index >> 6] ^= uint64_t(1) << (index & 63);
+	numSolidTiles += solid ? 1 : -1;
+}
+
+void TileCollisionGrid::SetLayer(unsigned int layer, unsigned int mask)
+{
+	this->layer = layer;
+	this->mask = mask;
+}
+
+unsigned int TileCollisionGrid::GetLayer() const
+{
+	return layer;
+}
+
+unsigned int TileCollisionGrid::GetMask() const
+{
+	return mask;
+}
+
+bool TileCollisionGrid::HasSolidTiles() const
+{
+	return numSolidTiles > 0;
+}
+
+int TileCollisionGrid::GetNumCols() const
+{
+	return numCols;
+}
+
+int TileCollisionGrid::GetNumRows() const
+{
+	return numRows;
+}
+
+float TileCollisionGrid::GetTileSize() const
+{
+	return tileSize;
+}
+
+int TileCollisionGrid::GetCol(float x) const
+{
+	return static_cast<int>(std::floor(x / tileSize));
+}
+
+int TileCollisionGrid::GetRow(float y) const
+{
+	return static_cast<int>(std::floor(y / tileSize));
+}
+
+bool TileCollisionGrid::IsSolidAt(float x, float y) const
+{
+	return IsSolid(GetCol(x), GetRow(y));
+}
+
+bool TileCollisionGrid::RowOverlapsSolid(int row, float minX, float maxX) const
+{
+	// Boxes only touching a tile edge do not overlap it, like in AABB::Overlaps
+	int firstCol = std::max(GetCol(minX), 0);
+	int lastCol = std::min(static_cast<int>(std::ceil(maxX / tileSize)) - 1, numCols - 1);
+
+	for (int col = firstCol; col <= lastCol; col++)
+	{
+		if (IsSolid(col, row))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TileCollisionGrid::OverlapsSolid(const AABB& box) const
+{
+	if (numSolidTiles == 0)
+	{
+		return false;
+	}
+
+	int firstRow = std::max(GetRow(box.minY), 0);
+	int lastRow = std::min(static_cast<int>(std::ceil(box.maxY / tileSize)) - 1, numRows - 1);
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		if (RowOverlapsSolid(row, box.minX, box.maxX))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TileCollisionGrid::SweepOverlapsSolid(const AABB& box, float deltaX, float deltaY) const
+{
+	if (numSolidTiles == 0)
+	{
+		return false;
+	}
+
+	AABB sweptBox = AABB::Union(box, AABB(box.minX + deltaX, box.minY + deltaY, box.maxX + deltaX, box.maxY + deltaY));
+	int firstRow = std::max(GetRow(sweptBox.minY), 0);
+	int lastRow = std::min(static_cast<int>(std::ceil(sweptBox.maxY / tileSize)) - 1, numRows - 1);
+
+	// Walk the rows the box crosses, and in each row only test the cells the box covers while it is in that row,
+	// so a box moving diagonally past the corner of a tile does not hit it
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		float entryFraction = 0.0f;
+		float exitFraction = 1.0f;
+		if (deltaY != 0.0f)
+		{
+			float rowMinY = row * tileSize;
+			float t1 = (rowMinY - box.maxY) / deltaY;
+			float t2 = (rowMinY + tileSize - box.minY) / deltaY;
+			entryFraction = std::max(entryFraction, std::min(t1, t2));
+			exitFraction = std::min(exitFraction, std::max(t1, t2));
+		}
+
+		if (entryFraction < exitFraction)
+		{
+			float minX = box.minX + std::min(entryFraction * deltaX, exitFraction * deltaX);
+			float maxX = box.maxX + std::max(entryFraction * deltaX, exitFraction * deltaX);
+			if (RowOverlapsSolid(row, minX, maxX))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
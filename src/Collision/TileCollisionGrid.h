@@ -0,0 +1,73 @@
+#ifndef TILE_COLLISION_GRID_H
+#define TILE_COLLISION_GRID_H
+
+#include "AABB.h"
+#include <cstdint>
+#include <vector>
+
+/*---------------------------------------------------------------------------*/
+// TileCollisionGrid
+/*---------------------------------------------------------------------------*/
+// One solidity bit per tile of the level tilemap, packed in 64-bit words.
+// Terrain is tested by looking up the cells under a box, so solid tiles
+// never become entities in the collision broadphase. Cells outside of the
+// map are not solid; the map edges are handled by the movement system.
+// The solid tiles share one collision layer and mask, so they only block the
+// colliders that can collide with that layer.
+/*---------------------------------------------------------------------------*/
+class TileCollisionGrid
+{
+private:
+	int numCols = 0;
+	int numRows = 0;
+	float tileSize = 1.0f;
+	int numSolidTiles = 0;
+	std::vector<uint64_t> solidBits;
+	unsigned int layer = 0;
+	unsigned int mask = 0;
+
+	// Returns true if any cell of the row from minX to maxX is solid
+	bool RowOverlapsSolid(int row, float minX, float maxX) const;
+
+public:
+	TileCollisionGrid() = default;
+	~TileCollisionGrid() = default;
+
+	// Clears the grid and sizes it for a tilemap; tileSize is the size of a tile in world pixels
+	void Reset(int numCols, int numRows, float tileSize);
+	void SetSolid(int col, int row, bool solid);
+
+	// Collision layer and mask of the solid tiles; no collider is blocked until the layer is set
+	void SetLayer(unsigned int layer, unsigned int mask);
+	unsigned int GetLayer() const;
+	unsigned int GetMask() const;
+
+	bool HasSolidTiles() const;
+	int GetNumCols() const;
+	int GetNumRows() const;
+	float GetTileSize() const;
+
+	int GetCol(float x) const;
+	int GetRow(float y) const;
+
+	bool IsSolid(int col, int row) const
+	{
+		if (col < 0 || row < 0 || col >= numCols || row >= numRows)
+		{
+			return false;
+		}
+
+		int index = row * numCols + col;
+		return (solidBits[index >> 6] >> (index & 63)) & 1;
+	}
+
+	bool IsSolidAt(float x, float y) const;
+
+	// Returns true if the box overlaps any solid tile
+	bool OverlapsSolid(const AABB& box) const;
+
+	// Returns true if the box overlaps a solid tile anywhere on its move by (deltaX, deltaY)
+	bool SweepOverlapsSolid(const AABB& box, float deltaX, float deltaY) const;
+};
+
+#endif
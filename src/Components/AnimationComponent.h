@@ -1,6 +1,7 @@
 #ifndef ANIMATION_COMPONENT_H
 #define ANIMATION_COMPONENT_H
 
+#include "../Game/GameClock.h"
 #include <SDL2/SDL.h>
 
 
@@ -18,7 +19,7 @@ struct AnimationComponent
 		this->currentFrame = 1;
 		this->frameSpeedRate = frameSpeedRate;
 		this->isLoop = isLoop;
-		this->startTime = SDL_GetTicks();
+		this->startTime = GameClock::GetTicks();
 	}
 };
 
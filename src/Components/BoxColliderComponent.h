@@ -1,6 +1,7 @@
 #ifndef BOX_COLLIDER_COMPONENT_H
 #define BOX_COLLIDER_COMPONENT_H
 
+#include "../Collision/CollisionLayers.h"
 #include <glm/glm.hpp>
 #include <SDL2/SDL.h>
 
@@ -12,13 +13,27 @@ struct BoxColliderComponent
 	glm::vec2 offset;
 	bool collision;
 
+	// Number of colliders overlapping this one; collision is set while it is above zero
+	int numContacts;
 
-	BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0))
+	// Collision layer bit of the collider, and mask with the layers it collides with
+	unsigned int layer;
+	unsigned int mask;
+
+	// Fast colliders are tested over their motion since the last update, so they can not tunnel through others
+	bool continuous;
+
+
+	BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0), unsigned int layer = 1, unsigned int mask = COLLISION_MASK_ALL, bool continuous = false)
 	{
 		this->width = width;
 		this->height = height;
 		this->offset = offset;
 		this->collision = false;
+		this->numContacts = 0;
+		this->layer = layer;
+		this->mask = mask;
+		this->continuous = continuous;
 	}
 };
 
@@ -1,6 +1,7 @@
 #ifndef PROJECTILE_COMPONENT_H
 #define PROJECTILE_COMPONENT_H
 
+#include "../Game/GameClock.h"
 #include <SDL2/SDL.h>
 
 struct ProjectileComponent
@@ -15,7 +16,7 @@ struct ProjectileComponent
 		this->isFriendly = isFriendly;
 		this->hitPercentDamage = hitPercentDamage;
 		this->duration = duration;
-		this->startTime = SDL_GetTicks();
+		this->startTime = GameClock::GetTicks();
 	}
 };
 
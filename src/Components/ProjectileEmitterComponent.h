@@ -1,6 +1,8 @@
 #ifndef PROJECTILE_EMITTER_COMPONENT_H
 #define PROJECTILE_EMITTER_COMPONENT_H
 
+#include "../Collision/CollisionLayers.h"
+#include "../Game/GameClock.h"
 #include <glm/glm.hpp>
 #include <SDL2/SDL.h>
 
@@ -14,14 +16,20 @@ struct ProjectileEmitterComponent
 	bool isFriendly;
 	int lastEmissionTime;
 
-	ProjectileEmitterComponent(glm::vec2 projectileVelocity = glm::vec2(0), int repeatFrequency = 0, int projectileDuration = 10000, int hitPercentDamage = 10, bool isFriendly = false)
+	// Collision layer and mask of the emitted projectiles, with the same defaults as BoxColliderComponent
+	unsigned int projectileLayer;
+	unsigned int projectileMask;
+
+	ProjectileEmitterComponent(glm::vec2 projectileVelocity = glm::vec2(0), int repeatFrequency = 0, int projectileDuration = 10000, int hitPercentDamage = 10, bool isFriendly = false, unsigned int projectileLayer = 1, unsigned int projectileMask = COLLISION_MASK_ALL)
 	{
 		this->projectileVelocity = projectileVelocity;
 		this->repeatFrequency = repeatFrequency;
 		this->projectileDuration = projectileDuration;
 		this->hitPercentDamage = hitPercentDamage;
 		this->isFriendly = isFriendly;
-		this->lastEmissionTime = SDL_GetTicks();
+		this->lastEmissionTime = GameClock::GetTicks();
+		this->projectileLayer = projectileLayer;
+		this->projectileMask = projectileMask;
 	}
 };
 
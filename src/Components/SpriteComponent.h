@@ -1,12 +1,12 @@
 #ifndef SPRITE_COMPONENT_H
 #define SPRITE_COMPONENT_H
 
-#include <string>
+#include "../AssetStore/AssetHandle.h"
 #include <SDL2/SDL.h>
 
 struct SpriteComponent
 {
-	std::string assetId;
+	TextureHandle texture;
 	int width;
 	int height;
 	int zIndex;
@@ -15,9 +15,9 @@ struct SpriteComponent
 	SDL_Rect srcRect;
 
 
-	SpriteComponent(std::string assetId = "", int width = 0, int height = 0, int zIndex = 0, bool isFixed = false, int srcRectX = 0, int srcRectY = 0)
+	SpriteComponent(TextureHandle texture = INVALID_ASSET_HANDLE, int width = 0, int height = 0, int zIndex = 0, bool isFixed = false, int srcRectX = 0, int srcRectY = 0)
 	{
-		this->assetId = assetId;
+		this->texture = texture;
 		this->width = width;
 		this->height = height;
 		this->zIndex = zIndex;
@@ -1,6 +1,7 @@
 #ifndef TEXT_LABEL_COMPONENT_H
 #define TEXT_LABEL_COMPONENT_H
 
+#include "../AssetStore/AssetHandle.h"
 #include <string>
 #include <glm/glm.hpp>
 #include <SDL2/SDL.h>
@@ -10,15 +11,15 @@ struct TextLabelComponent
 {
 	glm::vec2 position;
 	std::string text;
-	std::string assetId;
+	FontHandle font;
 	SDL_Color color;
 	bool isFixed;
 
-	TextLabelComponent(glm::vec2 position = glm::vec2(0), std::string text = "", std::string assetId = "", const SDL_Color& color = { 0, 0, 0 }, bool isFixed = true)
+	TextLabelComponent(glm::vec2 position = glm::vec2(0), std::string text = "", FontHandle font = INVALID_ASSET_HANDLE, const SDL_Color& color = { 0, 0, 0 }, bool isFixed = true)
 	{
 		this->position = position;
 		this->text = text;
-		this->assetId = assetId;
+		this->font = font;
 		this->color = color;
 		this->isFixed = isFixed;
 	}
@@ -34,6 +34,11 @@ bool Entity::BelongsToGroup(const std::string& group) const
     return registry->EntityBelongsToGroup(*this, group);
 }
 
+int Entity::GetGroupId() const
+{
+    return registry->GetEntityGroupId(*this);
+}
+
 void System::AddEntityToSystem(Entity entity)
 {
     entities.push_back(entity);
@@ -76,6 +81,12 @@ Entity Registry::CreateEntity()
         freeIds.pop_front();
     }
 
+    if (entityId >= static_cast<int>(aliveEntities.size()))
+    {
+        aliveEntities.resize(entityId + 1, false);
+    }
+    aliveEntities[entityId] = true;
+
     Entity entity(entityId);
     entity.registry = this;
     entitiesToBeAdded.insert(entity);
@@ -90,6 +101,11 @@ void Registry::KillEntity(Entity entity)
     Logger::Log("Entity " + std::to_string(entity.GetId()) + " was killed");
 }
 
+bool Registry::IsEntityAlive(int entityId) const
+{
+    return entityId >= 0 && entityId < static_cast<int>(aliveEntities.size()) && aliveEntities[entityId];
+}
+
 void Registry::AddEntityToSystems(Entity entity)
 {
     const auto entityId = entity.GetId();
@@ -150,19 +166,46 @@ void Registry::RemoveEntityTag(Entity entity)
 
 void Registry::GroupEntity(Entity entity, const std::string& group)
 {
-    entitiesPerGroup.emplace(group, std::set<Entity>());
+    // An entity belongs to one group at a time, so leave the previous one first
+    RemoveEntityGroup(entity);
+
     entitiesPerGroup[group].emplace(entity);
-    groupPerEntity.emplace(entity.GetId(), group);
+    groupPerEntity[entity.GetId()] = group;
+
+    if (entity.GetId() >= static_cast<int>(groupIdPerEntity.size()))
+    {
+        groupIdPerEntity.resize(entity.GetId() + 1, -1);
+    }
+    groupIdPerEntity[entity.GetId()] = GetGroupId(group);
+}
+
+int Registry::GetGroupId(const std::string& group)
+{
+    auto groupId = groupIds.find(group);
+    if (groupId != groupIds.end())
+    {
+        return groupId->second;
+    }
+
+    // Ids are given in order, the first time a group name is seen
+    const int newGroupId = static_cast<int>(groupIds.size());
+    groupIds.emplace(group, newGroupId);
+    return newGroupId;
+}
+
+int Registry::GetEntityGroupId(Entity entity) const
+{
+    return entity.GetId() < static_cast<int>(groupIdPerEntity.size()) ? groupIdPerEntity[entity.GetId()] : -1;
 }
 
 bool Registry::EntityBelongsToGroup(Entity entity, const std::string& group) const
 {
-    if (entitiesPerGroup.find(group) == entitiesPerGroup.end())
+    auto groupEntities = entitiesPerGroup.find(group);
+    if (groupEntities == entitiesPerGroup.end())
     {
         return false;
     }
-    auto groupEntities = entitiesPerGroup.at(group);
-    return groupEntities.find(entity.GetId()) != groupEntities.end();
+    return groupEntities->second.find(entity) != groupEntities->second.end();
 }
 
 std::vector<Entity> Registry::GetEntitiesByGroup(const std::string& group) const
@@ -187,6 +230,7 @@ void Registry::RemoveEntityGroup(Entity entity)
             }
         }
         groupPerEntity.erase(groupedEntity);
+        groupIdPerEntity[entity.GetId()] = -1;
     }
 }
 
@@ -216,6 +260,7 @@ void Registry::Update()
 
         // Make the entity id available to be reused
         freeIds.push_back(entity.GetId());
+        aliveEntities[entity.GetId()] = false;
 
         // Remove any traces of that entity from the tag/group maps
         RemoveEntityTag(entity);
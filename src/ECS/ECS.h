@@ -56,6 +56,7 @@ public:
 	bool HasTag(const std::string& tag) const;
 	void Group(const std::string& group);
 	bool BelongsToGroup(const std::string& group) const;
+	int GetGroupId() const;
 
 	// Manage entity components
 	template <typename TComponent, typename ...TArgs> void AddComponent(TArgs&& ...args);
@@ -88,8 +89,8 @@ private:
 public:
 	System() = default;
 	virtual ~System() = default; 
-	void AddEntityToSystem(Entity entity);
-	void RemoveEntityFromSystem(Entity entity);
+	virtual void AddEntityToSystem(Entity entity);
+	virtual void RemoveEntityFromSystem(Entity entity);
 	std::vector<Entity> GetSystemEntities() const;
 	const Signature& GetComponentSignature() const;
 
@@ -256,10 +257,19 @@ private:
 	std::unordered_map<std::string, std::set<Entity>> entitiesPerGroup;
 	std::unordered_map<int, std::string> groupPerEntity;
 
+	// Group ids, to look up the group of an entity without comparing names
+	// [Vector index = entity id]
+	// [Vector value = group id, or -1 if the entity has no group]
+	std::unordered_map<std::string, int> groupIds;
+	std::vector<int> groupIdPerEntity;
 
 	// List of free entities that wre previously removed
 	std::deque<int> freeIds;
 
+	// Whether each entity id is in use, from its creation until the entity is removed in Update()
+	// [Vector index = entity id]
+	std::vector<bool> aliveEntities;
+
 public:
 	Registry() 
 	{
@@ -276,6 +286,7 @@ public:
 	// Entity management
 	Entity CreateEntity();
 	void KillEntity(Entity entity);
+	bool IsEntityAlive(int entityId) const;
 
 	// Tag management
 	void TagEntity(Entity entity, const std::string& tag);
@@ -288,6 +299,8 @@ public:
 	bool EntityBelongsToGroup(Entity entity, const std::string& group) const;
 	std::vector<Entity> GetEntitiesByGroup(const std::string& group) const;
 	void RemoveEntityGroup(Entity entity);
+	int GetGroupId(const std::string& group);
+	int GetEntityGroupId(Entity entity) const;
 
 
 	// Component management
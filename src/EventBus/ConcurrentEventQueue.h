@@ -0,0 +1,147 @@
+#ifndef CONCURRENT_EVENT_QUEUE_H
+#define CONCURRENT_EVENT_QUEUE_H
+
+#include "EventBus.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Backpressure of a queue, summed over its producers
+struct ConcurrentEventQueueStats
+{
+	long long numPushed = 0;
+	long long numRejected = 0;
+	int highWaterMark = 0;
+	int capacity = 0;
+};
+
+/*---------------------------------------------------------------------------*/
+// ConcurrentEventQueue
+/*---------------------------------------------------------------------------*/
+// Events of type <TEvent> pushed from worker threads without a lock. Each
+// producer owns a bounded single-producer single-consumer ring, so a push
+// is two atomic loads and one store. A producer is an index and not a thread:
+// give each ParallelFor task its own producer index, and the main thread
+// drains the producers in index order at its sync point, so the events come
+// out in the same order whatever thread ran which task. A full ring rejects
+// the push and counts it, so memory stays bounded when the consumer lags.
+/*---------------------------------------------------------------------------*/
+template <typename TEvent>
+class ConcurrentEventQueue
+{
+private:
+	// The indexes only grow; their difference is the number of queued events
+	struct alignas(64) ProducerRing
+	{
+		// Written by the consumer
+		std::atomic<uint32_t> head{ 0 };
+
+		// Written by the producer, on its own cache line
+		alignas(64) std::atomic<uint32_t> tail{ 0 };
+		std::atomic<long long> numPushed{ 0 };
+		std::atomic<long long> numRejected{ 0 };
+		std::atomic<int> highWaterMark{ 0 };
+
+		std::vector<std::optional<TEvent>> slots;
+	};
+
+	std::vector<std::unique_ptr<ProducerRing>> rings;
+	uint32_t capacity;
+
+public:
+	// The capacity of each producer is rounded up to a power of two
+	ConcurrentEventQueue(int numProducers, int capacityPerProducer = 1024)
+	{
+		capacity = 1;
+		while (capacity < static_cast<uint32_t>(std::max(capacityPerProducer, 1)))
+		{
+			capacity <<= 1;
+		}
+
+		for (int i = 0; i < std::max(numProducers, 1); i++)
+		{
+			rings.push_back(std::make_unique<ProducerRing>());
+			rings.back()->slots.resize(capacity);
+		}
+	}
+
+	ConcurrentEventQueue(const ConcurrentEventQueue&) = delete;
+	ConcurrentEventQueue& operator=(const ConcurrentEventQueue&) = delete;
+
+	int GetNumProducers() const
+	{
+		return static_cast<int>(rings.size());
+	}
+
+	// Only one thread at a time may push with a given producer index; returns false if its ring is full
+	template <typename ...TArgs>
+	bool Push(int producer, TArgs&& ...args)
+	{
+		ProducerRing& ring = *rings[producer];
+		uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+		uint32_t size = tail - ring.head.load(std::memory_order_acquire);
+
+		if (size == capacity)
+		{
+			ring.numRejected.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		ring.slots[tail & (capacity - 1)].emplace(std::forward<TArgs>(args)...);
+		ring.tail.store(tail + 1, std::memory_order_release);
+
+		ring.numPushed.fetch_add(1, std::memory_order_relaxed);
+		if (static_cast<int>(size + 1) > ring.highWaterMark.load(std::memory_order_relaxed))
+		{
+			ring.highWaterMark.store(static_cast<int>(size + 1), std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	// Called by the consumer thread only; hands every queued event to callback(TEvent&), producer after producer
+	template <typename TCallback>
+	void Drain(TCallback callback)
+	{
+		for (auto& ring : rings)
+		{
+			uint32_t head = ring->head.load(std::memory_order_relaxed);
+			uint32_t tail = ring->tail.load(std::memory_order_acquire);
+
+			for (; head != tail; head++)
+			{
+				auto& slot = ring->slots[head & (capacity - 1)];
+				callback(*slot);
+				slot.reset();
+			}
+
+			ring->head.store(tail, std::memory_order_release);
+		}
+	}
+
+	// Emits the queued events on the bus, so they are dispatched with the other events of the frame
+	void Drain(EventBus& eventBus)
+	{
+		Drain([&eventBus](TEvent& event) {
+			eventBus.EmitEvent<TEvent>(std::move(event));
+		});
+	}
+
+	ConcurrentEventQueueStats GetStats() const
+	{
+		ConcurrentEventQueueStats stats;
+		stats.capacity = static_cast<int>(capacity);
+		for (const auto& ring : rings)
+		{
+			stats.numPushed += ring->numPushed.load(std::memory_order_relaxed);
+			stats.numRejected += ring->numRejected.load(std::memory_order_relaxed);
+			stats.highWaterMark = std::max(stats.highWaterMark, ring->highWaterMark.load(std::memory_order_relaxed));
+		}
+		return stats;
+	}
+};
+
+#endif
@@ -3,113 +3,365 @@
 
 #include "../Logger/Logger.h"
 #include "Event.h"
-#include <map>
-#include <typeindex>
+#include <algorithm>
+#include <cstddef>
 #include <memory>
-#include <list>
+#include <utility>
+#include <vector>
 
 
-class IEventCallback
+/*---------------------------------------------------------------------------*/
+// EventType
+/*---------------------------------------------------------------------------*/
+// Assigns a unique id to each event type, used to index the subscribers
+/*---------------------------------------------------------------------------*/
+class IEventType
 {
-private:
-	virtual void Call(Event& e) = 0;
+protected:
+	inline static int nextId = 0;
+};
 
+template <typename TEvent>
+class EventType: public IEventType
+{
 public:
-	virtual ~IEventCallback() = default;
-
-	void Execute(Event& e)
+	static int GetId()
 	{
-		Call(e);
+		static auto id = nextId++;
+		return id;
 	}
 };
 
+// Contiguous events of one type, handed at once to the handlers that take a whole batch
+template <typename TEvent>
+struct EventSpan
+{
+	TEvent* events;
+	std::size_t count;
+
+	TEvent* begin() const { return events; }
+	TEvent* end() const { return events + count; }
+	std::size_t size() const { return count; }
+	TEvent& operator[](std::size_t index) const { return events[index]; }
+};
+
+/*---------------------------------------------------------------------------*/
+// EventDelegate
+/*---------------------------------------------------------------------------*/
+// A subscriber callback as an owner pointer and a plain function that casts
+// the owner and the events back to their types and calls the member function,
+// so calling a subscriber needs neither a virtual call nor an allocation.
+// Handlers take either one event (TEvent&) or a batch (EventSpan<TEvent>).
+/*---------------------------------------------------------------------------*/
+template <typename TCallback> struct MemberCallbackTraits;
+
 template <typename TOwner, typename TEvent>
-class EventCallback: public IEventCallback
+struct MemberCallbackTraits<void(TOwner::*)(TEvent&)>
 {
-private:
-	typedef void(TOwner::*CallbackFunction)(TEvent&);
-	
-	TOwner* ownerInstace;
-	CallbackFunction callbackFunction;
-		
-	virtual void Call(Event& e) override
+	typedef TOwner Owner;
+	typedef TEvent EventType;
+	static const bool isBatch = false;
+};
+
+template <typename TOwner, typename TEvent>
+struct MemberCallbackTraits<void(TOwner::*)(EventSpan<TEvent>)>
+{
+	typedef TOwner Owner;
+	typedef TEvent EventType;
+	static const bool isBatch = true;
+};
+
+struct EventDelegate
+{
+	void* ownerInstance;
+	void (*function)(void* ownerInstance, void* events, std::size_t count);
+	int subscriptionId;
+
+	template <auto Callback>
+	static void Invoke(void* ownerInstance, void* events, std::size_t count)
 	{
-		std::invoke(callbackFunction, ownerInstace, static_cast<TEvent&>(e));
+		typedef MemberCallbackTraits<decltype(Callback)> Traits;
+		auto owner = static_cast<typename Traits::Owner*>(ownerInstance);
+		auto typedEvents = static_cast<typename Traits::EventType*>(events);
+
+		if constexpr (Traits::isBatch)
+		{
+			(owner->*Callback)(EventSpan<typename Traits::EventType>{ typedEvents, count });
+		}
+		else
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				(owner->*Callback)(typedEvents[i]);
+			}
+		}
 	}
+};
 
+/*---------------------------------------------------------------------------*/
+// EventQueue
+/*---------------------------------------------------------------------------*/
+// Events of one type waiting for the next flush, stored contiguously. While
+// they are dispatched, the events queued by the handlers go to a second array.
+/*---------------------------------------------------------------------------*/
+class IEventQueue
+{
 public:
-	EventCallback(TOwner* ownerInstance, CallbackFunction callbackFunction)
+	virtual ~IEventQueue() = default;
+	virtual bool IsEmpty() const = 0;
+	virtual void BeginDispatch() = 0;
+	virtual void* GetDispatchedEvents() = 0;
+	virtual std::size_t GetNumDispatchedEvents() const = 0;
+};
+
+template <typename TEvent>
+class EventQueue: public IEventQueue
+{
+private:
+	std::vector<TEvent> queued;
+	std::vector<TEvent> dispatched;
+
+public:
+	template <typename ...TArgs>
+	void Push(TArgs&& ...args)
+	{
+		queued.emplace_back(std::forward<TArgs>(args)...);
+	}
+
+	bool IsEmpty() const override { return queued.empty(); }
+
+	void BeginDispatch() override
 	{
-		this->ownerInstace = ownerInstance;
-		this->callbackFunction = callbackFunction;
+		dispatched.clear();
+		std::swap(queued, dispatched);
 	}
 
-	virtual ~EventCallback() override = default;
+	void* GetDispatchedEvents() override { return dispatched.data(); }
+	std::size_t GetNumDispatchedEvents() const override { return dispatched.size(); }
 };
 
-typedef std::list<std::unique_ptr<IEventCallback>> HandlerList;
+enum EventDispatchMode
+{
+	EVENT_DISPATCH_IMMEDIATE,
+	EVENT_DISPATCH_QUEUED
+};
+
+// Handle returned when subscribing, to unsubscribe later
+struct EventSubscription
+{
+	int eventId = -1;
+	int subscriptionId = -1;
+};
 
 class EventBus
 {
 private:
-	std::map<std::type_index, std::unique_ptr<HandlerList>> subscribers;
+	// [Vector index = event type id]
+	std::vector<std::vector<EventDelegate>> subscribers;
+	int nextSubscriptionId = 0;
+
+	// Subscribers removed while an event is being emitted are only cleared, and erased afterwards
+	int emitDepth = 0;
+	bool hasRemovedSubscribers = false;
+
+	// [Vector index = event type id]
+	std::vector<std::unique_ptr<IEventQueue>> queues;
+	EventDispatchMode dispatchMode = EVENT_DISPATCH_IMMEDIATE;
+	bool hasQueuedEvents = false;
+
+	// Rounds of a flush, when the handlers keep queuing events
+	static const int maxFlushRounds = 8;
+
+	void Dispatch(int eventId, void* events, std::size_t count)
+	{
+		emitDepth++;
+		std::size_t numDelegates = subscribers[eventId].size();
+		for (std::size_t i = 0; i < numDelegates; i++)
+		{
+			// A handler may have reset the bus
+			if (eventId >= static_cast<int>(subscribers.size()) || i >= subscribers[eventId].size())
+			{
+				break;
+			}
+
+			// Copied, as a handler may subscribe and grow the vector
+			EventDelegate delegate = subscribers[eventId][i];
+			if (delegate.function)
+			{
+				delegate.function(delegate.ownerInstance, events, count);
+			}
+		}
+		emitDepth--;
+
+		if (emitDepth == 0 && hasRemovedSubscribers)
+		{
+			EraseRemovedSubscribers();
+		}
+	}
+
+	void EraseRemovedSubscribers()
+	{
+		for (auto& delegates : subscribers)
+		{
+			delegates.erase(std::remove_if(delegates.begin(), delegates.end(), [](const EventDelegate& delegate) {
+				return delegate.function == nullptr;
+				}), delegates.end());
+		}
+		hasRemovedSubscribers = false;
+	}
 
 public:
 	EventBus()
 	{
 		Logger::Log("EventBus constructor called!");
 	}
-	
+
 	~EventBus()
 	{
 		Logger::Log("EventBus destructor called!");
 	}
 
 	// Clear the subscribers list
-	void Reset() 
+	void Reset()
 	{
 		subscribers.clear();
+		queues.clear();
+		hasQueuedEvents = false;
+	}
+
+	// In queued mode, EmitEvent only queues the events until the next Flush
+	void SetDispatchMode(EventDispatchMode mode)
+	{
+		dispatchMode = mode;
+	}
+
+	EventDispatchMode GetDispatchMode() const
+	{
+		return dispatchMode;
 	}
 
 	/*--------------------------------------------------------------------------*/
-	// Subscribe to an event of type <TEvent>
-	// Implemented as a listener subscribing to an event
-	// Example: eventBus->SubscribeToEvent<CollisionEvent>(this, &Game::onCollision);
+	// Subscribe to an event, with the member function that handles it
+	// The subscription lasts until it is unsubscribed or the bus is reset
+	// Example: eventBus->SubscribeToEvent<&Game::OnCollision>(this);
+	// A handler taking an EventSpan<TEvent> gets the queued events in one call
 	/*--------------------------------------------------------------------------*/
-	template <typename TEvent, typename TOwner>
-	void SubsrcibeToEvent(TOwner* ownerInstance, void(TOwner::* callbackFuntion)(TEvent&))
+	template <auto Callback>
+	EventSubscription SubscribeToEvent(typename MemberCallbackTraits<decltype(Callback)>::Owner* ownerInstance)
+	{
+		typedef typename MemberCallbackTraits<decltype(Callback)>::EventType TEvent;
+
+		int eventId = EventType<TEvent>::GetId();
+		if (eventId >= static_cast<int>(subscribers.size()))
+		{
+			subscribers.resize(eventId + 1);
+		}
+
+		int subscriptionId = nextSubscriptionId++;
+		subscribers[eventId].push_back({ ownerInstance, &EventDelegate::Invoke<Callback>, subscriptionId });
+
+		return { eventId, subscriptionId };
+	}
+
+	void Unsubscribe(EventSubscription subscription)
 	{
-		if (!subscribers[typeid(TEvent)].get())
+		if (subscription.eventId < 0 || subscription.eventId >= static_cast<int>(subscribers.size()))
 		{
-			subscribers[typeid(TEvent)] = std::make_unique<HandlerList>();
+			return;
 		}
 
-		auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, callbackFuntion);
-		subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
+		for (auto& delegate : subscribers[subscription.eventId])
+		{
+			if (delegate.subscriptionId == subscription.subscriptionId)
+			{
+				delegate.function = nullptr;
+				hasRemovedSubscribers = true;
+			}
+		}
+
+		if (emitDepth == 0 && hasRemovedSubscribers)
+		{
+			EraseRemovedSubscribers();
+		}
 	}
 
 	/*--------------------------------------------------------------------------*/
 	// Emit an event of type <TEvent>
-	// As soon as an something emits an event, all the listeners callback 
-	// functions are executed
+	// The event is created once, and all the listeners callback functions are
+	// executed with it; in queued mode it waits for the next flush instead
 	// Example: eventBus->EmitEvent<CollisionEvent>(player, enemy);
 	/*--------------------------------------------------------------------------*/
 	template <typename TEvent, typename ...TArgs>
 	void EmitEvent(TArgs&& ...args)
 	{
-		auto handlers = subscribers[typeid(TEvent)].get();
-		
-		if (handlers)
+		if (dispatchMode == EVENT_DISPATCH_QUEUED)
 		{
-			for (auto it = handlers->begin(); it != handlers->end(); it++)
+			QueueEvent<TEvent>(std::forward<TArgs>(args)...);
+			return;
+		}
+
+		int eventId = EventType<TEvent>::GetId();
+		if (eventId >= static_cast<int>(subscribers.size()) || subscribers[eventId].empty())
+		{
+			return;
+		}
+
+		TEvent event(std::forward<TArgs>(args)...);
+		Dispatch(eventId, &event, 1);
+	}
+
+	// Append an event to the array of its type, to be dispatched at the next flush
+	template <typename TEvent, typename ...TArgs>
+	void QueueEvent(TArgs&& ...args)
+	{
+		int eventId = EventType<TEvent>::GetId();
+		if (eventId >= static_cast<int>(subscribers.size()) || subscribers[eventId].empty())
+		{
+			return;
+		}
+
+		if (eventId >= static_cast<int>(queues.size()))
+		{
+			queues.resize(eventId + 1);
+		}
+		if (!queues[eventId])
+		{
+			queues[eventId] = std::make_unique<EventQueue<TEvent>>();
+		}
+
+		static_cast<EventQueue<TEvent>*>(queues[eventId].get())->Push(std::forward<TArgs>(args)...);
+		hasQueuedEvents = true;
+	}
+
+	/*--------------------------------------------------------------------------*/
+	// Dispatch the queued events, one event type after the other (by type id),
+	// and each type in the order its events were queued. Events queued by the
+	// handlers are dispatched in the same flush.
+	/*--------------------------------------------------------------------------*/
+	void Flush()
+	{
+		for (int round = 0; hasQueuedEvents; round++)
+		{
+			if (round == maxFlushRounds)
 			{
-				auto handler = it->get();
-				TEvent event(std::forward<TArgs>(args)...);
-				handler->Execute(event);
+				Logger::Err("Events are still being queued after " + std::to_string(maxFlushRounds) + " flush rounds");
+				break;
+			}
+
+			hasQueuedEvents = false;
+			for (std::size_t eventId = 0; eventId < queues.size(); eventId++)
+			{
+				if (!queues[eventId] || queues[eventId]->IsEmpty())
+				{
+					continue;
+				}
+
+				IEventQueue* queue = queues[eventId].get();
+				queue->BeginDispatch();
+				Dispatch(static_cast<int>(eventId), queue->GetDispatchedEvents(), queue->GetNumDispatchedEvents());
 			}
 		}
 	}
 };
 
 #endif
-
@@ -0,0 +1,13 @@
+#ifndef COLLISION_ENTER_EVENT_H
+#define COLLISION_ENTER_EVENT_H
+
+#include "CollisionEvent.h"
+
+// Emitted once, on the first frame two colliders overlap
+class CollisionEnterEvent: public CollisionEvent
+{
+public:
+	CollisionEnterEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef COLLISION_EXIT_EVENT_H
+#define COLLISION_EXIT_EVENT_H
+
+#include "CollisionEvent.h"
+
+// Emitted once, on the first frame two colliders stop overlapping
+class CollisionExitEvent: public CollisionEvent
+{
+public:
+	CollisionExitEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+#endif
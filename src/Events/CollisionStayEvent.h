@@ -0,0 +1,13 @@
+#ifndef COLLISION_STAY_EVENT_H
+#define COLLISION_STAY_EVENT_H
+
+#include "CollisionEvent.h"
+
+// Emitted on every frame two colliders keep overlapping after they entered, when enabled
+class CollisionStayEvent: public CollisionEvent
+{
+public:
+	CollisionStayEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "LevelLoader.h"
+#include "GameClock.h"
 #include "../Logger/Logger.h"
 #include "../ECS/ECS.h"
 #include "../Systems/MovementSystem.h"
@@ -20,6 +21,8 @@
 #include <imgui_impl_sdl.h>
 #include <imgui_impl_sdlrenderer.h>
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
 
 
 int Game::windowWidth;
@@ -27,13 +30,16 @@ int Game::windowHeight;
 int Game::mapWidth;
 int Game::mapHeight;
 
-Game::Game()
+Game::Game(): keyPressedEvents(1)
 {
 	isRunning = false;
 	debug = false;
 	registry = std::make_unique<Registry>();
 	assetStore = std::make_unique<AssetStore>();
 	eventBus = std::make_unique<EventBus>();
+	tilemap = std::make_unique<Tilemap>();
+	tileCollisionGrid = std::make_unique<TileCollisionGrid>();
+	tilemapChunks = std::make_unique<TilemapChunks>();
 	Logger::Log("Game constructor called!");
 }
 
@@ -42,9 +48,45 @@ Game::~Game()
 	Logger::Log("Game destructor called!");
 }
 
+void Game::EnableHeadless(int numFrames, const std::string& pngFile)
+{
+	headless = true;
+	numHeadlessFrames = numFrames;
+	headlessPngFile = pngFile;
+}
+
+void Game::EnablePipelinedRendering()
+{
+	pipelinedRendering = true;
+}
+
+void Game::SetLevel(int levelNumber)
+{
+	this->levelNumber = levelNumber;
+}
+
+bool Game::SetBroadphase(const std::string& broadphaseName)
+{
+	for (int type = 0; type < static_cast<int>(sizeof(broadphaseNames) / sizeof(broadphaseNames[0])); type++)
+	{
+		if (broadphaseName == broadphaseNames[type])
+		{
+			broadphaseOverride = type;
+			return true;
+		}
+	}
+	return false;
+}
+
 void Game::Initialize()
 {
-	if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
+	// The dummy video driver works without a display; audio and input devices are not opened
+	if (headless)
+	{
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+	}
+
+	if (SDL_Init(headless ? SDL_INIT_VIDEO | SDL_INIT_TIMER : SDL_INIT_EVERYTHING) != 0)
 	{
 		Logger::Err("Error initialising SDL.");
 		return;
@@ -61,6 +103,28 @@ void Game::Initialize()
 
 	windowWidth = 1280; //displayMode.w;
 	windowHeight = 1024; //displayMode.h;
+
+	// Initialize the camera view with the entire screen
+	camera.x = 0;
+	camera.y = 0;
+	camera.w = windowWidth;
+	camera.h = windowHeight;
+
+	if (headless)
+	{
+		window = nullptr;
+		headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, windowWidth, windowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+		renderer = headlessSurface ? SDL_CreateSoftwareRenderer(headlessSurface) : nullptr;
+
+		if (!renderer)
+		{
+			Logger::Err("Error creating the headless software renderer.");
+			return;
+		}
+
+		isRunning = true;
+		return;
+	}
 	
 	window = SDL_CreateWindow(
 		NULL,
@@ -92,12 +156,6 @@ void Game::Initialize()
 	ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
 	ImGui_ImplSDLRenderer_Init(renderer);
 
-	// Initialize the camera view with the entire screen
-	camera.x = 0;
-	camera.y = 0;
-	camera.w = windowWidth;
-	camera.h = windowHeight;
-
 	isRunning = true;
 }
 
@@ -124,6 +182,11 @@ void Game::ProcessInput()
 				isRunning = false;
 				break;
 
+			// The contents of the render target textures were lost
+			case SDL_RENDER_TARGETS_RESET:
+				tilemapChunks->Bake(renderer);
+				break;
+
 			case SDL_KEYDOWN:
 				if (sdlEvent.key.keysym.sym == SDLK_ESCAPE)
 				{
@@ -135,10 +198,23 @@ void Game::ProcessInput()
 					Logger::Log("Debug status " + (debug ? std::string("active") : std::string("inactive")));
 				}
 				
-				eventBus->EmitEvent<KeyPressedEvent>(sdlEvent.key.keysym.sym);
+				if (pipelinedRendering)
+				{
+					keyPressedEvents.Push(0, sdlEvent.key.keysym.sym);
+				}
+				else
+				{
+					eventBus->EmitEvent<KeyPressedEvent>(sdlEvent.key.keysym.sym);
+				}
 				break;
 		};
 	}
+
+	// Flush point: the key presses of the frame are handled before the systems update
+	if (!pipelinedRendering)
+	{
+		eventBus->Flush();
+	}
 }
 
 void Game::Setup()
@@ -159,13 +235,32 @@ void Game::Setup()
 	registry->AddSystem<RenderGuiSystem>();
 	registry->AddSystem<ScriptSystem>();
 
+	// Events are queued per type and dispatched in bulk at the flush points of the frame
+	eventBus->SetDispatchMode(EVENT_DISPATCH_QUEUED);
+
+	// Perform the subscription of the events for all systems; subscriptions last until they are removed
+	registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
+	registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
+
+	// Register the collision handlers, per pair of groups
+	registry->GetSystem<MovementSystem>().SubscribeToCollisions(registry);
+	registry->GetSystem<DamageSystem>().SubscribeToCollisions(registry);
+
 	// Creaste the bindings between C++ and LUa
-	registry->GetSystem<ScriptSystem>().CreateLuaBinding(lua);
+	registry->GetSystem<ScriptSystem>().CreateLuaBinding(lua, registry);
 
 	// Load the first level
 	LevelLoader loader;
 	lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
-    loader.LoadLevel(lua, registry, assetStore, renderer, 2);
+    loader.LoadLevel(lua, registry, assetStore, tilemap, tileCollisionGrid, tilemapChunks, renderer, levelNumber);
+	if (broadphaseOverride >= 0)
+	{
+		registry->GetSystem<CollisionSystem>().SetBroadphase(static_cast<BroadphaseType>(broadphaseOverride));
+	}
+	registry->GetSystem<ProjectileEmitSystem>().SetProjectileTexture(assetStore->GetTextureHandle("bullet-texture"));
+	registry->GetSystem<RenderHealthBarSystem>().SetLabelFonts(
+		assetStore->GetGlyphAtlas(assetStore->GetFontHandle("pico8-font-5")),
+		assetStore->GetGlyphAtlas(assetStore->GetFontHandle("pico8-font-8")));
 }
 
 void Game::Update()
@@ -185,43 +280,68 @@ void Game::Update()
 	// Store the current frame time
 	millisecsPreviousFrame = SDL_GetTicks();
 
-	// Reset all event handlers for the current frame
-	eventBus->Reset();
-
-	// Perform the subscription of the events for all systems
-	registry->GetSystem<MovementSystem>().SubscribeToEvents(eventBus);
-	registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
-	registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
-	registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
+	UpdateSystems(deltaTime, SDL_GetTicks());
+}
 
+void Game::UpdateSystems(double deltaTime, int elapsedTime)
+{
 	// Update the registray to process the entities that are waiting to be created/deleted
 	registry->Update();
 
 	// Invoke all the systems that need to update
-	registry->GetSystem<MovementSystem>().Update(deltaTime);
+	registry->GetSystem<MovementSystem>().Update(deltaTime, tileCollisionGrid);
 	registry->GetSystem<AnimationSystem>().Update();
 	registry->GetSystem<CollisionSystem>().Update(eventBus);
+	eventBus->Flush();
 	registry->GetSystem<ProjectileEmitSystem>().Update(registry);
 	registry->GetSystem<ProjectileLifecycleSystem>().Update();
 	registry->GetSystem<CameraMovementSystem>().Update(camera);
-	registry->GetSystem<ScriptSystem>().Update(deltaTime, SDL_GetTicks());
+	registry->GetSystem<ScriptSystem>().Update(deltaTime, elapsedTime);
 }
 
-void Game::Render()
+void Game::RecordRenderCommands(RenderCommandList& commandList)
 {
-	SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
-	SDL_RenderClear(renderer);
+	commandList.Reset(camera);
 
 	// Invoke all the systems that need to render
-	registry->GetSystem<RenderSystem>().Update(renderer, assetStore, camera);
-	registry->GetSystem<RenderTextSystem>().Update(renderer, assetStore, camera);
-	registry->GetSystem<RenderHealthBarSystem>().Update(renderer, assetStore, camera);
+	commandList.BeginStage(RENDER_STAGE_SPRITES);
+	registry->GetSystem<RenderSystem>().Update(commandList, assetStore, camera);
+	commandList.BeginStage(RENDER_STAGE_TEXT);
+	registry->GetSystem<RenderTextSystem>().Update(commandList, assetStore, camera);
+	commandList.BeginStage(RENDER_STAGE_HEALTH_BARS);
+	registry->GetSystem<RenderHealthBarSystem>().Update(commandList, camera);
 
 	if (debug)
 	{
 		// Render the colliders
-		registry->GetSystem<RenderCollisionSystem>().Update(renderer, camera);
-		registry->GetSystem<RenderGuiSystem>().Update(registry, camera);
+		commandList.BeginStage(RENDER_STAGE_COLLIDERS);
+		registry->GetSystem<RenderCollisionSystem>().Update(commandList, camera);
+	}
+}
+
+void Game::Render(const RenderCommandList& commandList)
+{
+	SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
+	SDL_RenderClear(renderer);
+
+	// Draw the tilemap under the sprites
+	renderBenchmark.BeginStage();
+	tilemapChunks->Render(renderer, commandList.GetCamera());
+	renderBenchmark.EndStage(RENDER_STAGE_TILEMAP, tilemapChunks->GetNumDrawCalls());
+
+	for (int stage = RENDER_STAGE_SPRITES; stage < NUM_RENDER_STAGES; stage++)
+	{
+		renderBenchmark.BeginStage();
+		spriteBatch.ResetStats();
+		commandList.Execute(renderer, spriteBatch, static_cast<RenderStage>(stage));
+		renderBenchmark.EndStage(static_cast<RenderStage>(stage), spriteBatch.GetNumDrawCalls());
+	}
+	renderBenchmark.EndFrame();
+
+	// The debug window needs a window for ImGui, and reads the registry while it draws
+	if (debug && !headless && !pipelinedRendering)
+	{
+		registry->GetSystem<RenderGuiSystem>().Update(registry, assetStore, camera);
 	}
 
 	SDL_RenderPresent(renderer);
@@ -229,21 +349,125 @@ void Game::Render()
 
 void Game::Run()
 {
+	if (headless)
+	{
+		RunHeadless();
+		return;
+	}
+
 	Setup();
+	if (pipelinedRendering)
+	{
+		RunPipelined();
+		return;
+	}
+
 	while (isRunning)
 	{
 		ProcessInput();
 		Update();
-		Render();
+		RecordRenderCommands(commandList);
+		Render(commandList);
+	}
+}
+
+void Game::RunPipelined()
+{
+	// Simulation thread: the frame N + 1 is simulated and recorded while the frame N is drawn
+	framePipeline.Start([this](RenderCommandList& commandList) {
+		keyPressedEvents.Drain(*eventBus);
+		eventBus->Flush();
+		Update();
+		RecordRenderCommands(commandList);
+		return isRunning.load();
+	});
+
+	// Main thread: the input is read and the frames are drawn as soon as they are recorded
+	while (const RenderCommandList* frame = framePipeline.AcquireFrame())
+	{
+		ProcessInput();
+		Render(*frame);
+		framePipeline.ReleaseFrame();
+
+		if (!isRunning)
+		{
+			break;
+		}
+	}
+	framePipeline.Stop();
+}
+
+void Game::RunHeadless()
+{
+	if (!isRunning)
+	{
+		return;
+	}
+
+	// A fixed time step, so that two runs give the same frames
+	GameClock::SetFixedTicks(0);
+	Setup();
+
+	// The collision timings are summed too, to compare the broadphases on the same frames
+	const auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+	double broadphaseMilliseconds = 0.0;
+	double narrowphaseMilliseconds = 0.0;
+	long long numColliders = 0;
+	long long numCandidatePairs = 0;
+	long long numCollisions = 0;
+
+	for (int frame = 1; frame <= numHeadlessFrames; frame++)
+	{
+		GameClock::SetFixedTicks(frame * MILLISECS_PER_FRAME);
+		eventBus->Flush();
+		UpdateSystems(MILLISECS_PER_FRAME / 1000.0, GameClock::GetTicks());
+		RecordRenderCommands(commandList);
+		Render(commandList);
+
+		const auto& stats = collisionSystem.GetStats();
+		broadphaseMilliseconds += stats.lastBroadphaseMilliseconds;
+		narrowphaseMilliseconds += stats.lastNarrowphaseMilliseconds;
+		numColliders += stats.numColliders;
+		numCandidatePairs += stats.numCandidatePairs;
+		numCollisions += stats.numCollisions;
+	}
+
+	renderBenchmark.Report();
+
+	char collisionReport[256];
+	std::snprintf(collisionReport, sizeof(collisionReport),
+		"Collision benchmark, level %d, %s: broadphase %.3f ms, narrowphase %.3f ms, %.1f colliders, %.1f candidate pairs, %.1f contacts per frame",
+		levelNumber, broadphaseNames[collisionSystem.GetBroadphaseType()],
+		broadphaseMilliseconds / numHeadlessFrames, narrowphaseMilliseconds / numHeadlessFrames,
+		static_cast<double>(numColliders) / numHeadlessFrames, static_cast<double>(numCandidatePairs) / numHeadlessFrames,
+		static_cast<double>(numCollisions) / numHeadlessFrames);
+	Logger::Log(collisionReport);
+
+	char checksum[32];
+	std::snprintf(checksum, sizeof(checksum), "%016llx", static_cast<unsigned long long>(RenderBenchmark::GetChecksum(headlessSurface)));
+	Logger::Log("Checksum of the last frame: " + std::string(checksum));
+
+	if (!headlessPngFile.empty() && IMG_SavePNG(headlessSurface, headlessPngFile.c_str()) != 0)
+	{
+		Logger::Err("Could not save the last frame to " + headlessPngFile);
 	}
 }
 
 void Game::Destroy()
 {
-	ImGui_ImplSDLRenderer_Shutdown();
-	ImGui_ImplSDL2_Shutdown();
-	ImGui::DestroyContext();
+	if (!headless)
+	{
+		ImGui_ImplSDLRenderer_Shutdown();
+		ImGui_ImplSDL2_Shutdown();
+		ImGui::DestroyContext();
+	}
+	tilemapChunks->Clear();
+	assetStore->ClearAssets();
 	SDL_DestroyRenderer(renderer);
-	SDL_DestroyWindow(window);
+	if (!headless)
+	{
+		SDL_DestroyWindow(window);
+	}
+	SDL_FreeSurface(headlessSurface);
 	SDL_Quit();
 }
\ No newline at end of file
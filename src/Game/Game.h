@@ -4,7 +4,18 @@
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
 #include "../EventBus/EventBus.h"
+#include "../EventBus/ConcurrentEventQueue.h"
+#include "../Events/KeyPressedEvent.h"
+#include "../Collision/TileCollisionGrid.h"
+#include "../Render/RenderBenchmark.h"
+#include "../Render/RenderCommandList.h"
+#include "../Render/SpriteBatch.h"
+#include "../Render/TilemapChunks.h"
+#include "../Threading/FramePipeline.h"
+#include "../Tilemap/Tilemap.h"
+#include <atomic>
 #include <memory>
+#include <string>
 #include <sol/sol.hpp>
 #include <SDL2/SDL.h>
 
@@ -16,8 +27,9 @@ const int MILLISECS_PER_FRAME = 1000 / FPS;
 class Game
 {
 private:
-	bool isRunning;
-	bool debug;
+	// Also read by the simulation thread when the frames are pipelined
+	std::atomic<bool> isRunning;
+	std::atomic<bool> debug;
 	int millisecsPreviousFrame = 0;
 	SDL_Window* window;
 	SDL_Renderer* renderer;
@@ -28,17 +40,58 @@ private:
 	std::unique_ptr<Registry> registry;
 	std::unique_ptr<AssetStore> assetStore;
 	std::unique_ptr<EventBus> eventBus;
+	std::unique_ptr<Tilemap> tilemap;
+	std::unique_ptr<TileCollisionGrid> tileCollisionGrid;
+	std::unique_ptr<TilemapChunks> tilemapChunks;
+
+	// Headless runs draw a fixed number of frames with the software renderer into an offscreen
+	// surface, at a fixed time step, and report the render timings and the checksum of the last frame
+	bool headless = false;
+	int numHeadlessFrames = 0;
+	std::string headlessPngFile;
+	SDL_Surface* headlessSurface = nullptr;
+	RenderBenchmark renderBenchmark;
+
+	// Level loaded by Setup, and the broadphase used instead of the one the level sets (-1 to keep it)
+	int levelNumber = 2;
+	int broadphaseOverride = -1;
+
+	// The render systems record the frame into a command list, which Render draws through the sprite batch
+	RenderCommandList commandList;
+	SpriteBatch spriteBatch;
+
+	// With the render pipeline, the simulation and the recording of a frame run on their own thread while
+	// the main thread, which owns the window and the renderer, handles the input and draws the previous frame.
+	// The key presses go to the simulation through a queue; the ImGui debug window needs the synchronous loop.
+	bool pipelinedRendering = false;
+	FramePipeline framePipeline;
+	ConcurrentEventQueue<KeyPressedEvent> keyPressedEvents;
+
+	void UpdateSystems(double deltaTime, int elapsedTime);
+	void RecordRenderCommands(RenderCommandList& commandList);
+	void Render(const RenderCommandList& commandList);
+	void RunHeadless();
+	void RunPipelined();
 
 public:
 	Game();
 	~Game();
 
+	// Must be called before Initialize; the last frame is saved to the PNG file if one is given
+	void EnableHeadless(int numFrames, const std::string& pngFile);
+
+	// Must be called before Run
+	void EnablePipelinedRendering();
+
+	// Must be called before Run; SetBroadphase returns false for an unknown broadphase name
+	void SetLevel(int levelNumber);
+	bool SetBroadphase(const std::string& broadphaseName);
+
 	void Initialize();
 	void Run();
 	void Setup();
 	void ProcessInput();
 	void Update();
-	void Render();
 	void Destroy();
 
 	static int windowWidth;
@@ -0,0 +1,32 @@
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+#include <SDL2/SDL.h>
+
+/*---------------------------------------------------------------------------*/
+// GameClock
+/*---------------------------------------------------------------------------*/
+// Milliseconds as seen by the timers of the components and the systems. It
+// follows SDL_GetTicks, except in headless runs, where the game steps it by
+// a fixed amount per frame so that two runs draw the same frames.
+/*---------------------------------------------------------------------------*/
+class GameClock
+{
+private:
+	static inline bool isFixedStep = false;
+	static inline Uint32 fixedTicks = 0;
+
+public:
+	static Uint32 GetTicks()
+	{
+		return isFixedStep ? fixedTicks : SDL_GetTicks();
+	}
+
+	static void SetFixedTicks(Uint32 ticks)
+	{
+		isFixedStep = true;
+		fixedTicks = ticks;
+	}
+};
+
+#endif
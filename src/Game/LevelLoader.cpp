@@ -10,10 +10,26 @@
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/HealthComponent.h"
 #include "../Components/ScriptComponent.h"
-#include <fstream>
+#include "../Systems/CollisionSystem.h"
+#include "../Collision/CollisionLayers.h"
+#include <algorithm>
+#include <cctype>
+#include <set>
 #include <string>
 #include <sol/sol.hpp>
 
+// Builds a collision mask from a lua list of layer names
+static unsigned int ReadCollisionMask(const sol::table& layerNames)
+{
+    unsigned int mask = 0;
+    for (std::size_t n = 1; n <= layerNames.size(); n++)
+    {
+        std::string layerName = layerNames[n];
+        mask |= CollisionLayers::RegisterLayer(layerName);
+    }
+    return mask;
+}
+
 LevelLoader::LevelLoader()
 {
     Logger::Log("LevelLoader constructor called!");
@@ -24,7 +40,7 @@ LevelLoader::~LevelLoader()
     Logger::Log("LevelLoader destructor called!");
 }
 
-void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber)
+void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, const std::unique_ptr<Tilemap>& tilemap, const std::unique_ptr<TileCollisionGrid>& tileCollisionGrid, const std::unique_ptr<TilemapChunks>& tilemapChunks, SDL_Renderer* renderer, int levelNumber)
 {
     // This checks the syntax of our script, but it does not execute the script
     sol::load_result script = lua.load_file("./assets/scripts/Level" + std::to_string(levelNumber) + ".lua");
@@ -60,7 +76,9 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
         std::string assetId = asset["id"];
         if (assetType == "texture")
         {
-            assetStore->AddTexture(renderer, assetId, asset["file"]);
+            // Small textures flagged with atlas = true share the atlas pages built below
+            bool packInAtlas = asset["atlas"].get_or(false);
+            assetStore->AddTexture(renderer, assetId, asset["file"], packInAtlas);
             Logger::Log("A new texture asset was added to the asset store, id: " + assetId);
         }
         if (assetType == "font")
@@ -70,6 +88,8 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
         }
         i++;
     }
+    assetStore->BuildAtlases(renderer);
+    assetStore->BuildGlyphAtlases(renderer);
 
     //----------------------------------------------------------
     // Read the level tilemap information
@@ -79,34 +99,131 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
     std::string mapTextureAssetId = map["texture_asset_id"];
     int mapNumRows = map["num_rows"];
     int mapNumCols = map["num_cols"];
-    int tileSize = map["tile_size"];
     double mapScale = map["scale"];
-    std::fstream mapFile;
-    mapFile.open(mapFilePath);
-    if (!mapFile)
+
+    Tileset tileset;
+    tileset.texture = assetStore->GetTextureHandle(mapTextureAssetId);
+    tileset.tileSize = map["tile_size"];
+    tileset.numCols = map["tileset_cols"].get_or(10);
+
+    // Tiles listed as solid (by their "row col" code in the tilemap texture) block the colliders that collide with "terrain"
+    sol::optional<sol::table> hasSolidTiles = map["solid_tiles"];
+    if (hasSolidTiles != sol::nullopt)
     {
-        Logger::Err("Could not open tilemap file " + mapFilePath);
+        sol::table solidTiles = map["solid_tiles"];
+        for (std::size_t n = 1; n <= solidTiles.size(); n++)
+        {
+            std::string tileCode = solidTiles[n];
+            if (tileCode.size() == 2 && std::isdigit(tileCode[0]) && std::isdigit(tileCode[1]))
+            {
+                std::size_t tile = (tileCode[0] - '0') * tileset.numCols + (tileCode[1] - '0');
+                tileset.isSolidTile.resize(std::max(tileset.isSolidTile.size(), tile + 1), false);
+                tileset.isSolidTile[tile] = true;
+            }
+            else
+            {
+                Logger::Err("Invalid solid tile code " + tileCode);
+            }
+        }
     }
 
+    // The map file is the bottom layer; the files listed in layers are drawn over it, in order
+    tilemap->Reset(mapNumCols, mapNumRows, static_cast<float>(mapScale), tileset);
+    tilemap->LoadLayer(mapFilePath);
+    sol::optional<sol::table> hasLayers = map["layers"];
+    if (hasLayers != sol::nullopt)
+    {
+        sol::table layers = map["layers"];
+        for (std::size_t n = 1; n <= layers.size(); n++)
+        {
+            std::string layerFilePath = layers[n];
+            tilemap->LoadLayer(layerFilePath);
+        }
+    }
+
+    tileCollisionGrid->Reset(mapNumCols, mapNumRows, tilemap->GetTileWorldSize());
     for (int y = 0; y < mapNumRows; y++)
     {
         for (int x = 0; x < mapNumCols; x++)
         {
-            char ch;
-            mapFile.get(ch);
-            int srcRectY = std::atoi(&ch) * tileSize;
-            mapFile.get(ch);
-            int srcRectX = std::atoi(&ch) * tileSize;
-            mapFile.ignore();
-
-            Entity tile = registry->CreateEntity();
-            tile.AddComponent<TransformComponent>(glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize)), glm::vec2(mapScale, mapScale), 0.0);
-            tile.AddComponent<SpriteComponent>(mapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY);
+            tileCollisionGrid->SetSolid(x, y, tilemap->IsSolid(x, y));
+        }
+    }
+
+    // The tiles are not entities: they are baked into chunk textures drawn under the sprites
+    tilemapChunks->SetTilemap(tilemap.get(), assetStore->GetTexture(tileset.texture), assetStore->GetTextureRegion(tileset.texture));
+    tilemapChunks->Bake(renderer);
+    Game::mapWidth = static_cast<int>(tilemap->GetWorldWidth());
+    Game::mapHeight = static_cast<int>(tilemap->GetWorldHeight());
+
+    //----------------------------------------------------------
+    // Read the level collision settings
+    //----------------------------------------------------------
+    CollisionLayers::Reset();
+    sol::optional<sol::table> hasCollision = level["collision"];
+    if (hasCollision != sol::nullopt)
+    {
+        sol::table collision = level["collision"];
+        std::string broadphase = collision["broadphase"].get_or(std::string("spatial_grid"));
+        auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+
+        collisionSystem.SetSpatialGridCellSize(collision["cell_size"].get_or(64.0));
+        collisionSystem.SetDynamicTreeMargin(collision["fat_margin"].get_or(8.0));
+        collisionSystem.SetEmitStayEvents(collision["stay_events"].get_or(false));
+
+        if (broadphase == "dynamic_tree")
+        {
+            collisionSystem.SetBroadphase(BROADPHASE_DYNAMIC_TREE);
+        }
+        else if (broadphase == "sweep_and_prune")
+        {
+            collisionSystem.SetBroadphase(BROADPHASE_SWEEP_AND_PRUNE);
+        }
+        else
+        {
+            if (broadphase != "spatial_grid")
+            {
+                Logger::Err("Unknown collision broadphase " + broadphase + ", using spatial_grid");
+            }
+            collisionSystem.SetBroadphase(BROADPHASE_SPATIAL_GRID);
         }
+
+        // Layers each collision layer can collide with, used by the colliders that do not set their own
+        sol::optional<sol::table> hasLayers = collision["layers"];
+        if (hasLayers != sol::nullopt)
+        {
+            sol::table layers = collision["layers"];
+
+            // Lua tables have no order, so the layer names are registered sorted to get the same bits every run
+            std::set<std::string> layerNames;
+            for (const auto& layer : layers)
+            {
+                layerNames.insert(layer.first.as<std::string>());
+                sol::table collidesWith = layer.second.as<sol::table>();
+                for (std::size_t n = 1; n <= collidesWith.size(); n++)
+                {
+                    layerNames.insert(collidesWith[n].get<std::string>());
+                }
+            }
+            for (const auto& layerName : layerNames)
+            {
+                CollisionLayers::RegisterLayer(layerName);
+            }
+
+            for (const auto& layer : layers)
+            {
+                std::string layerName = layer.first.as<std::string>();
+                CollisionLayers::SetDefaultMask(CollisionLayers::FindLayer(layerName), ReadCollisionMask(layer.second.as<sol::table>()));
+            }
+        }
+    }
+
+    // The solid tiles are in the "terrain" layer, and only block the colliders whose mask includes it
+    if (tileCollisionGrid->HasSolidTiles())
+    {
+        unsigned int terrainLayer = CollisionLayers::RegisterLayer("terrain");
+        tileCollisionGrid->SetLayer(terrainLayer, CollisionLayers::GetDefaultMask(terrainLayer));
     }
-    mapFile.close();
-    Game::mapWidth = mapNumCols * tileSize * mapScale;
-    Game::mapHeight = mapNumRows * tileSize * mapScale;
 
     //----------------------------------------------------------
     // Read the level entities and their components
@@ -176,8 +293,9 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
             sol::optional<sol::table> sprite = entity["components"]["sprite"];
             if (sprite != sol::nullopt)
             {
+                std::string textureAssetId = entity["components"]["sprite"]["texture_asset_id"];
                 newEntity.AddComponent<SpriteComponent>(
-                    entity["components"]["sprite"]["texture_asset_id"],
+                    assetStore->GetTextureHandle(textureAssetId),
                     entity["components"]["sprite"]["width"],
                     entity["components"]["sprite"]["height"],
                     entity["components"]["sprite"]["z_index"].get_or(1),
@@ -201,13 +319,29 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
             sol::optional<sol::table> collider = entity["components"]["boxcollider"];
             if (collider != sol::nullopt)
             {
+                // The collision layer defaults to the group (or tag) of the entity
+                std::string layerName = entity["components"]["boxcollider"]["layer"].get_or(
+                    entity["group"].get_or(entity["tag"].get_or(std::string("default")))
+                );
+                unsigned int layer = CollisionLayers::RegisterLayer(layerName);
+
+                unsigned int mask = CollisionLayers::GetDefaultMask(layer);
+                sol::optional<sol::table> collidesWith = entity["components"]["boxcollider"]["collides_with"];
+                if (collidesWith != sol::nullopt)
+                {
+                    mask = ReadCollisionMask(entity["components"]["boxcollider"]["collides_with"]);
+                }
+
                 newEntity.AddComponent<BoxColliderComponent>(
                     entity["components"]["boxcollider"]["width"],
                     entity["components"]["boxcollider"]["height"],
                     glm::vec2(
                         entity["components"]["boxcollider"]["offset"]["x"].get_or(0),
                         entity["components"]["boxcollider"]["offset"]["y"].get_or(0)
-                    )
+                    ),
+                    layer,
+                    mask,
+                    entity["components"]["boxcollider"]["continuous"].get_or(false)
                     );
             }
 
@@ -224,6 +358,18 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
             sol::optional<sol::table> projectileEmitter = entity["components"]["projectile_emitter"];
             if (projectileEmitter != sol::nullopt)
             {
+                // The projectiles are in the group "projectiles", and their layer defaults to it like for the other colliders
+                unsigned int projectileLayer = CollisionLayers::RegisterLayer(
+                    entity["components"]["projectile_emitter"]["layer"].get_or(std::string("projectiles"))
+                );
+
+                unsigned int projectileMask = CollisionLayers::GetDefaultMask(projectileLayer);
+                sol::optional<sol::table> collidesWith = entity["components"]["projectile_emitter"]["collides_with"];
+                if (collidesWith != sol::nullopt)
+                {
+                    projectileMask = ReadCollisionMask(entity["components"]["projectile_emitter"]["collides_with"]);
+                }
+
                 newEntity.AddComponent<ProjectileEmitterComponent>(
                     glm::vec2(
                         entity["components"]["projectile_emitter"]["projectile_velocity"]["x"],
@@ -232,7 +378,9 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
                     static_cast<int>(entity["components"]["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
                     static_cast<int>(entity["components"]["projectile_emitter"]["projectile_duration"].get_or(10)) * 1000,
                     static_cast<int>(entity["components"]["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
-                    entity["components"]["projectile_emitter"]["friendly"].get_or(false)
+                    entity["components"]["projectile_emitter"]["friendly"].get_or(false),
+                    projectileLayer,
+                    projectileMask
                     );
             }
 
@@ -3,6 +3,9 @@
 
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Collision/TileCollisionGrid.h"
+#include "../Render/TilemapChunks.h"
+#include "../Tilemap/Tilemap.h"
 #include <sol/sol.hpp>
 #include <memory>
 #include <SDL2/SDL.h>
@@ -14,7 +17,7 @@ public:
 	LevelLoader();
 	~LevelLoader();
 
-	void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber);
+	void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, const std::unique_ptr<Tilemap>& tilemap, const std::unique_ptr<TileCollisionGrid>& tileCollisionGrid, const std::unique_ptr<TilemapChunks>& tilemapChunks, SDL_Renderer* renderer, int levelNumber);
 };
 
 #endif
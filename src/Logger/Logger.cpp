@@ -3,9 +3,13 @@
 #include <string>
 #include <chrono>
 #include <ctime>
+#include <mutex>
 
 std::vector<LogEntry> Logger::messages;
 
+// The simulation and the main thread both log when the frames are pipelined
+static std::mutex logMutex;
+
 std::string CurrentDateTimeToString()
 {
 	std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
@@ -25,6 +29,7 @@ std::string CurrentDateTimeToString()
 
 void Logger::Log(const std::string& message)
 {
+	std::lock_guard<std::mutex> lock(logMutex);
 	LogEntry logEntry;
 	logEntry.type = LOG_INFO;
 	logEntry.message = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
@@ -34,6 +39,7 @@ void Logger::Log(const std::string& message)
 
 void Logger::Err(const std::string& message)
 {
+	std::lock_guard<std::mutex> lock(logMutex);
 	LogEntry logEntry;
 	logEntry.type = LOG_ERROR;
 	logEntry.message = "ERR: [" + CurrentDateTimeToString() + "]: " + message;
@@ -1,12 +1,110 @@
 #include "Game/Game.h"
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+static const char* usage =
+    "Usage: gameengine [--headless [number of frames]] [--png file] [--pipelined] [--level number] [--broadphase name]\n"
+    "  --headless    render the given number of frames (600 by default) without a display, to benchmark them\n"
+    "  --png         save the last headless frame to a png file\n"
+    "  --pipelined   simulate the next frame on another thread while the current one is drawn\n"
+    "  --level       level to load (2 by default)\n"
+    "  --broadphase  spatial_grid, dynamic_tree or sweep_and_prune, instead of the one the level sets\n";
+
+static bool IsNumber(const std::string& arg)
+{
+    if (arg.empty() || arg.size() > 9)
+    {
+        return false;
+    }
+    for (char c : arg)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(c)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
 int main(int argc, char* argv[]) 
 {
+    bool headless = false;
+    int numFrames = 600;
+    std::string pngFile;
+    bool pipelined = false;
+    int levelNumber = 0;
+    std::string broadphase;
+
+    // The flags can come in any order, and each one at most once
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--headless" && !headless)
+        {
+            headless = true;
+            if (i + 1 < argc && IsNumber(argv[i + 1]))
+            {
+                numFrames = std::atoi(argv[++i]);
+            }
+        }
+        else if (arg == "--png" && pngFile.empty() && i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0)
+        {
+            pngFile = argv[++i];
+        }
+        else if (arg == "--pipelined" && !pipelined)
+        {
+            pipelined = true;
+        }
+        else if (arg == "--level" && levelNumber == 0 && i + 1 < argc && IsNumber(argv[i + 1]) && std::atoi(argv[i + 1]) > 0)
+        {
+            levelNumber = std::atoi(argv[++i]);
+        }
+        else if (arg == "--broadphase" && broadphase.empty() && i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0)
+        {
+            broadphase = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unexpected argument " << arg << "\n" << usage;
+            return 1;
+        }
+    }
+
+    if (!pngFile.empty() && !headless)
+    {
+        std::cerr << "--png needs --headless\n" << usage;
+        return 1;
+    }
+    if (headless && numFrames <= 0)
+    {
+        std::cerr << "--headless needs a positive number of frames\n" << usage;
+        return 1;
+    }
+
     Game game;
+    if (headless)
+    {
+        game.EnableHeadless(numFrames, pngFile);
+    }
+    if (pipelined)
+    {
+        game.EnablePipelinedRendering();
+    }
+    if (levelNumber > 0)
+    {
+        game.SetLevel(levelNumber);
+    }
+    if (!broadphase.empty() && !game.SetBroadphase(broadphase))
+    {
+        std::cerr << "Unknown broadphase " << broadphase << "\n" << usage;
+        return 1;
+    }
 
     game.Initialize();
     game.Run();
     game.Destroy();
 
     return 0;
-}
\ No newline at end of file
+}
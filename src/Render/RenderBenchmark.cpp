@@ -0,0 +1,61 @@
+#include "RenderBenchmark.h"
+#include "../Logger/Logger.h"
+#include <cstdio>
+
+void RenderBenchmark::BeginStage()
+{
+	stageStart = SDL_GetPerformanceCounter();
+}
+
+void RenderBenchmark::EndStage(RenderStage stage, int numDrawCalls)
+{
+	stages[stage].totalMilliseconds += (SDL_GetPerformanceCounter() - stageStart) * 1000.0 / SDL_GetPerformanceFrequency();
+	stages[stage].totalDrawCalls += numDrawCalls;
+}
+
+void RenderBenchmark::EndFrame()
+{
+	numFrames++;
+}
+
+void RenderBenchmark::Report() const
+{
+	if (numFrames == 0)
+	{
+		return;
+	}
+
+	Logger::Log("Render benchmark over " + std::to_string(numFrames) + " frames:");
+	for (int stage = 0; stage < NUM_RENDER_STAGES; stage++)
+	{
+		char line[128];
+		std::snprintf(line, sizeof(line), "  %-12s %8.3f ms/frame %8.1f draw calls/frame",
+			renderStageNames[stage],
+			stages[stage].totalMilliseconds / numFrames,
+			static_cast<double>(stages[stage].totalDrawCalls) / numFrames);
+		Logger::Log(line);
+	}
+}
+
+uint64_t RenderBenchmark::GetChecksum(SDL_Surface* surface)
+{
+	uint64_t hash = 14695981039346656037ull;
+	if (!surface || SDL_LockSurface(surface) != 0)
+	{
+		return hash;
+	}
+
+	int rowSize = surface->w * surface->format->BytesPerPixel;
+	for (int y = 0; y < surface->h; y++)
+	{
+		const uint8_t* row = static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch;
+		for (int x = 0; x < rowSize; x++)
+		{
+			hash ^= row[x];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	SDL_UnlockSurface(surface);
+	return hash;
+}
@@ -0,0 +1,54 @@
+#ifndef RENDER_BENCHMARK_H
+#define RENDER_BENCHMARK_H
+
+#include <cstdint>
+#include <string>
+#include <SDL2/SDL.h>
+
+enum RenderStage
+{
+	RENDER_STAGE_TILEMAP,
+	RENDER_STAGE_SPRITES,
+	RENDER_STAGE_TEXT,
+	RENDER_STAGE_HEALTH_BARS,
+	RENDER_STAGE_COLLIDERS,
+	NUM_RENDER_STAGES
+};
+
+// Names used in the benchmark report
+static const char* const renderStageNames[] = { "tilemap", "sprites", "text", "health bars", "colliders" };
+
+/*---------------------------------------------------------------------------*/
+// RenderBenchmark
+/*---------------------------------------------------------------------------*/
+// Times the stages of Game::Render and counts their draw calls over a run.
+// With the software renderer drawing into a surface, the frame can also be
+// reduced to a checksum, or saved as a PNG, to check that a rendering
+// change gives the same pixels as before.
+/*---------------------------------------------------------------------------*/
+class RenderBenchmark
+{
+private:
+	struct StageStats
+	{
+		double totalMilliseconds = 0.0;
+		long long totalDrawCalls = 0;
+	};
+
+	StageStats stages[NUM_RENDER_STAGES];
+	int numFrames = 0;
+	Uint64 stageStart = 0;
+
+public:
+	void BeginStage();
+	void EndStage(RenderStage stage, int numDrawCalls);
+	void EndFrame();
+
+	// Average time and draw calls per frame of every stage, in the log
+	void Report() const;
+
+	// FNV-1a hash of the visible pixels of the surface, the padding at the end of the rows left out
+	static uint64_t GetChecksum(SDL_Surface* surface);
+};
+
+#endif
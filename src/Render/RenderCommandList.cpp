@@ -0,0 +1,92 @@
+#include "RenderCommandList.h"
+
+RenderCommandList::RenderCommandList()
+{
+	Reset(camera);
+}
+
+void RenderCommandList::Reset(const SDL_Rect& camera)
+{
+	commands.clear();
+	for (int i = 0; i < NUM_RENDER_STAGES; i++)
+	{
+		stageBegin[i] = stageEnd[i] = 0;
+	}
+	stage = RENDER_STAGE_TILEMAP;
+	this->camera = camera;
+}
+
+void RenderCommandList::BeginStage(RenderStage stage)
+{
+	this->stage = stage;
+	stageBegin[stage] = stageEnd[stage] = static_cast<int>(commands.size());
+}
+
+void RenderCommandList::AddSprite(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& dstRect, double angle, SDL_RendererFlip flip, SDL_Color color)
+{
+	if (!texture)
+	{
+		return;
+	}
+
+	commands.push_back({ RENDER_COMMAND_SPRITE, texture, srcRect, dstRect, static_cast<float>(angle), flip, color });
+	stageEnd[stage] = static_cast<int>(commands.size());
+}
+
+void RenderCommandList::AddFillRect(const SDL_Rect& rect, SDL_Color color)
+{
+	commands.push_back({ RENDER_COMMAND_FILL_RECT, nullptr, { 0, 0, 0, 0 }, rect, 0.0f, SDL_FLIP_NONE, color });
+	stageEnd[stage] = static_cast<int>(commands.size());
+}
+
+void RenderCommandList::AddDrawRect(const SDL_Rect& rect, SDL_Color color)
+{
+	commands.push_back({ RENDER_COMMAND_DRAW_RECT, nullptr, { 0, 0, 0, 0 }, rect, 0.0f, SDL_FLIP_NONE, color });
+	stageEnd[stage] = static_cast<int>(commands.size());
+}
+
+const SDL_Rect& RenderCommandList::GetCamera() const
+{
+	return camera;
+}
+
+int RenderCommandList::GetNumCommands() const
+{
+	return static_cast<int>(commands.size());
+}
+
+void RenderCommandList::Execute(SDL_Renderer* renderer, SpriteBatch& spriteBatch, RenderStage stage) const
+{
+	for (int i = stageBegin[stage]; i < stageEnd[stage]; i++)
+	{
+		const RenderCommand& command = commands[i];
+		const SDL_Rect& rect = command.dstRect;
+		switch (command.type)
+		{
+			case RENDER_COMMAND_SPRITE:
+				spriteBatch.Add(renderer, command.texture, command.srcRect, rect, command.angle, command.flip, command.color);
+				break;
+
+			case RENDER_COMMAND_FILL_RECT:
+				spriteBatch.AddRect(renderer, rect, command.color);
+				break;
+
+			case RENDER_COMMAND_DRAW_RECT:
+				if (rect.w > 0 && rect.h > 0)
+				{
+					spriteBatch.AddRect(renderer, { rect.x, rect.y, rect.w, 1 }, command.color);
+					if (rect.h > 1)
+					{
+						spriteBatch.AddRect(renderer, { rect.x, rect.y + rect.h - 1, rect.w, 1 }, command.color);
+					}
+					if (rect.h > 2)
+					{
+						spriteBatch.AddRect(renderer, { rect.x, rect.y + 1, 1, rect.h - 2 }, command.color);
+						spriteBatch.AddRect(renderer, { rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2 }, command.color);
+					}
+				}
+				break;
+		}
+	}
+	spriteBatch.Flush(renderer);
+}
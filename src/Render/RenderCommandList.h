@@ -0,0 +1,68 @@
+#ifndef RENDER_COMMAND_LIST_H
+#define RENDER_COMMAND_LIST_H
+
+#include "RenderBenchmark.h"
+#include "SpriteBatch.h"
+#include <vector>
+#include <SDL2/SDL.h>
+
+enum RenderCommandType
+{
+	RENDER_COMMAND_SPRITE,
+	RENDER_COMMAND_FILL_RECT,
+	RENDER_COMMAND_DRAW_RECT
+};
+
+// One draw of the frame, in screen coordinates; the rectangles have no texture
+struct RenderCommand
+{
+	RenderCommandType type;
+	SDL_Texture* texture;
+	SDL_Rect srcRect;
+	SDL_Rect dstRect;
+	float angle;
+	SDL_RendererFlip flip;
+	SDL_Color color;
+};
+
+/*---------------------------------------------------------------------------*/
+// RenderCommandList
+/*---------------------------------------------------------------------------*/
+// What the render systems want drawn in a frame, recorded from the game
+// state without any call to the renderer, and grouped by render stage. The
+// list is read only once recorded, so it can be drawn while the next frame
+// is simulated and recorded into another list.
+/*---------------------------------------------------------------------------*/
+class RenderCommandList
+{
+private:
+	std::vector<RenderCommand> commands;
+
+	// [Array index = render stage] The commands of a stage are recorded in one go
+	int stageBegin[NUM_RENDER_STAGES];
+	int stageEnd[NUM_RENDER_STAGES];
+	RenderStage stage = RENDER_STAGE_TILEMAP;
+
+	SDL_Rect camera = { 0, 0, 0, 0 };
+
+public:
+	RenderCommandList();
+
+	// Starts a new frame seen through the camera; the capacity of the list is kept
+	void Reset(const SDL_Rect& camera);
+	void BeginStage(RenderStage stage);
+
+	void AddSprite(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& dstRect, double angle, SDL_RendererFlip flip, SDL_Color color = { 255, 255, 255, 255 });
+	void AddFillRect(const SDL_Rect& rect, SDL_Color color);
+
+	// One pixel wide outline, like SDL_RenderDrawRect
+	void AddDrawRect(const SDL_Rect& rect, SDL_Color color);
+
+	const SDL_Rect& GetCamera() const;
+	int GetNumCommands() const;
+
+	// Draws the commands of the stage through the batch, and flushes it
+	void Execute(SDL_Renderer* renderer, SpriteBatch& spriteBatch, RenderStage stage) const;
+};
+
+#endif
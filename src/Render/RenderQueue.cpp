@@ -0,0 +1,193 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+uint64_t RenderQueue::MakeSortKey(int zIndex, bool isFixed, int texture, int depth)
+{
+	uint64_t biasedZIndex = static_cast<uint64_t>(std::min(std::max(zIndex, -32768), 32767) + 32768);
+
+	return (biasedZIndex << 48) |
+		(static_cast<uint64_t>(isFixed) << 47) |
+		(static_cast<uint64_t>(texture & 0x7fff) << 32) |
+		static_cast<uint32_t>(depth);
+}
+
+void RenderQueue::Add(Entity entity, uint64_t sortKey)
+{
+	addedItems.push_back({ sortKey, entity, false });
+}
+
+void RenderQueue::Remove(Entity entity)
+{
+	int entityId = entity.GetId();
+
+	// An entity added since the last sort is still waiting in the added items
+	for (auto it = addedItems.begin(); it != addedItems.end(); ++it)
+	{
+		if (it->entity == entity)
+		{
+			addedItems.erase(it);
+			return;
+		}
+	}
+
+	if (entityId >= static_cast<int>(itemIndexPerEntity.size()) || itemIndexPerEntity[entityId] < 0)
+	{
+		return;
+	}
+
+	items[itemIndexPerEntity[entityId]].isRemoved = true;
+	itemIndexPerEntity[entityId] = -1;
+	numRemoved++;
+}
+
+void RenderQueue::Clear()
+{
+	items.clear();
+	addedItems.clear();
+	itemIndexPerEntity.clear();
+	numRemoved = 0;
+	numKeysChanged = 0;
+}
+
+void RenderQueue::SetSortKey(Entity entity, uint64_t sortKey)
+{
+	int entityId = entity.GetId();
+	if (entityId < static_cast<int>(itemIndexPerEntity.size()) && itemIndexPerEntity[entityId] >= 0)
+	{
+		auto& item = items[itemIndexPerEntity[entityId]];
+		if (item.sortKey != sortKey)
+		{
+			item.sortKey = sortKey;
+			numKeysChanged++;
+		}
+		return;
+	}
+
+	// Not sorted in yet, so the new key is used when the added items are merged
+	for (auto& item : addedItems)
+	{
+		if (item.entity == entity)
+		{
+			item.sortKey = sortKey;
+			return;
+		}
+	}
+}
+
+void RenderQueue::Sort()
+{
+	if (numRemoved == 0 && numKeysChanged == 0 && addedItems.empty())
+	{
+		return;
+	}
+
+	// Only the items from the first one that moved need their index written again
+	int firstMoved = static_cast<int>(items.size());
+
+	if (numRemoved > 0)
+	{
+		auto isRemoved = [](const RenderQueueItem& item) {
+			return item.isRemoved;
+		};
+		auto firstRemoved = std::find_if(items.begin(), items.end(), isRemoved);
+		firstMoved = static_cast<int>(firstRemoved - items.begin());
+		items.erase(std::remove_if(firstRemoved, items.end(), isRemoved), items.end());
+	}
+
+	int numChanges = numKeysChanged + static_cast<int>(addedItems.size());
+	firstMoved = std::min(firstMoved, static_cast<int>(items.size()));
+	items.insert(items.end(), addedItems.begin(), addedItems.end());
+	addedItems.clear();
+
+	if (numChanges <= maxInsertionSortChanges)
+	{
+		firstMoved = std::min(firstMoved, InsertionSort());
+	}
+	else
+	{
+		RadixSort();
+		firstMoved = 0;
+	}
+
+	for (int i = firstMoved; i < static_cast<int>(items.size()); i++)
+	{
+		int entityId = items[i].entity.GetId();
+		if (entityId >= static_cast<int>(itemIndexPerEntity.size()))
+		{
+			itemIndexPerEntity.resize(entityId + 1, -1);
+		}
+		itemIndexPerEntity[entityId] = i;
+	}
+
+	numRemoved = 0;
+	numKeysChanged = 0;
+}
+
+// Linear on a queue where only a few items are out of place; returns the first index it wrote, or the size if none
+int RenderQueue::InsertionSort()
+{
+	std::size_t firstMoved = items.size();
+	for (std::size_t i = 1; i < items.size(); i++)
+	{
+		if (items[i - 1].sortKey <= items[i].sortKey)
+		{
+			continue;
+		}
+
+		RenderQueueItem item = items[i];
+		std::size_t j = i;
+		while (j > 0 && items[j - 1].sortKey > item.sortKey)
+		{
+			items[j] = items[j - 1];
+			j--;
+		}
+		items[j] = item;
+		firstMoved = std::min(firstMoved, j);
+	}
+
+	return static_cast<int>(firstMoved);
+}
+
+// Stable LSD radix sort on the bytes of the keys; the bytes that are the same in all keys are skipped
+void RenderQueue::RadixSort()
+{
+	if (items.empty())
+	{
+		return;
+	}
+
+	const int numPasses = 8;
+	std::size_t counts[numPasses][256] = {};
+
+	for (const auto& item : items)
+	{
+		for (int pass = 0; pass < numPasses; pass++)
+		{
+			counts[pass][(item.sortKey >> (pass * 8)) & 0xff]++;
+		}
+	}
+
+	scratch.assign(items.begin(), items.end());
+	for (int pass = 0; pass < numPasses; pass++)
+	{
+		int shift = pass * 8;
+		if (counts[pass][(items[0].sortKey >> shift) & 0xff] == items.size())
+		{
+			continue;
+		}
+
+		std::size_t offsets[256];
+		std::size_t offset = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			offsets[digit] = offset;
+			offset += counts[pass][digit];
+		}
+
+		for (const auto& item : items)
+		{
+			scratch[offsets[(item.sortKey >> shift) & 0xff]++] = item;
+		}
+		items.swap(scratch);
+	}
+}
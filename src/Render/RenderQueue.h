@@ -0,0 +1,69 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "../ECS/ECS.h"
+#include <cstdint>
+#include <vector>
+
+struct RenderQueueItem
+{
+	uint64_t sortKey;
+	Entity entity;
+	bool isRemoved;
+};
+
+/*---------------------------------------------------------------------------*/
+// RenderQueue
+/*---------------------------------------------------------------------------*/
+// The sprites to draw, kept sorted by a packed 64-bit key from one frame to
+// the next. Sprites added, removed or whose key changed are only recorded,
+// and Sort brings the queue back in order: an insertion pass when a few items
+// changed, a radix sort when many did (like the tiles of a new level).
+// Key bits, from the most significant:
+// [16: zIndex] [1: fixed] [15: texture] [32: depth (entity id)]
+/*---------------------------------------------------------------------------*/
+class RenderQueue
+{
+private:
+	std::vector<RenderQueueItem> items;
+	std::vector<RenderQueueItem> addedItems;
+	std::vector<RenderQueueItem> scratch;
+
+	// [Vector index = entity id]
+	// [Vector value = index of the entity in the items, or -1 if it is not sorted in yet]
+	std::vector<int> itemIndexPerEntity;
+
+	int numRemoved = 0;
+	int numKeysChanged = 0;
+
+	// Above this many changes, the queue is radix sorted
+	static const int maxInsertionSortChanges = 32;
+
+	int InsertionSort();
+	void RadixSort();
+
+public:
+	static uint64_t MakeSortKey(int zIndex, bool isFixed, int texture, int depth);
+
+	void Add(Entity entity, uint64_t sortKey);
+	void Remove(Entity entity);
+	void Clear();
+
+	int Size() const
+	{
+		return static_cast<int>(items.size());
+	}
+
+	const RenderQueueItem& operator [](int index) const
+	{
+		return items[index];
+	}
+
+	// Changes the key of an entity added before, if it differs
+	void SetSortKey(Entity entity, uint64_t sortKey);
+
+	// Drops the removed items, merges the added ones and restores the order
+	void Sort();
+};
+
+#endif
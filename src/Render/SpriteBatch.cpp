@@ -0,0 +1,145 @@
+#include "SpriteBatch.h"
+#include <cmath>
+#include <utility>
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SPRITE_BATCH_GEOMETRY
+#endif
+
+void SpriteBatch::Add(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& dstRect, double angle, SDL_RendererFlip flip, SDL_Color color)
+{
+	if (!texture)
+	{
+		return;
+	}
+
+#ifdef SPRITE_BATCH_GEOMETRY
+	if (texture != this->texture)
+	{
+		Flush(renderer);
+
+		int width = 1;
+		int height = 1;
+		SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+		this->texture = texture;
+		textureWidth = static_cast<float>(width);
+		textureHeight = static_cast<float>(height);
+	}
+
+	float u0 = srcRect.x / textureWidth;
+	float v0 = srcRect.y / textureHeight;
+	float u1 = (srcRect.x + srcRect.w) / textureWidth;
+	float v1 = (srcRect.y + srcRect.h) / textureHeight;
+	if (flip & SDL_FLIP_HORIZONTAL)
+	{
+		std::swap(u0, u1);
+	}
+	if (flip & SDL_FLIP_VERTICAL)
+	{
+		std::swap(v0, v1);
+	}
+
+	// Corners relative to the center, clockwise from the top left
+	float halfWidth = dstRect.w * 0.5f;
+	float halfHeight = dstRect.h * 0.5f;
+	float centerX = dstRect.x + halfWidth;
+	float centerY = dstRect.y + halfHeight;
+	const float cornerX[4] = { -halfWidth, halfWidth, halfWidth, -halfWidth };
+	const float cornerY[4] = { -halfHeight, -halfHeight, halfHeight, halfHeight };
+	const float cornerU[4] = { u0, u1, u1, u0 };
+	const float cornerV[4] = { v0, v0, v1, v1 };
+
+	float cosAngle = 1.0f;
+	float sinAngle = 0.0f;
+	if (angle != 0.0)
+	{
+		double radians = angle * 3.14159265358979323846 / 180.0;
+		cosAngle = static_cast<float>(std::cos(radians));
+		sinAngle = static_cast<float>(std::sin(radians));
+	}
+
+	int first = static_cast<int>(vertices.size());
+	for (int corner = 0; corner < 4; corner++)
+	{
+		SDL_Vertex vertex;
+		vertex.position.x = centerX + cornerX[corner] * cosAngle - cornerY[corner] * sinAngle;
+		vertex.position.y = centerY + cornerX[corner] * sinAngle + cornerY[corner] * cosAngle;
+		vertex.color = color;
+		vertex.tex_coord.x = cornerU[corner];
+		vertex.tex_coord.y = cornerV[corner];
+		vertices.push_back(vertex);
+	}
+
+	const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int index : quadIndices)
+	{
+		indices.push_back(first + index);
+	}
+#else
+	SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+	SDL_RenderCopyEx(renderer, texture, &srcRect, &dstRect, angle, NULL, flip);
+	SDL_SetTextureColorMod(texture, 255, 255, 255);
+	numDrawCalls++;
+#endif
+}
+
+void SpriteBatch::AddRect(SDL_Renderer* renderer, const SDL_Rect& rect, SDL_Color color)
+{
+#ifdef SPRITE_BATCH_GEOMETRY
+	// The rectangles are the run without a texture
+	if (texture)
+	{
+		Flush(renderer);
+	}
+
+	const float cornerX[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+	const float cornerY[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	int first = static_cast<int>(vertices.size());
+	for (int corner = 0; corner < 4; corner++)
+	{
+		SDL_Vertex vertex;
+		vertex.position.x = rect.x + cornerX[corner] * rect.w;
+		vertex.position.y = rect.y + cornerY[corner] * rect.h;
+		vertex.color = color;
+		vertex.tex_coord.x = 0.0f;
+		vertex.tex_coord.y = 0.0f;
+		vertices.push_back(vertex);
+	}
+
+	const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int index : quadIndices)
+	{
+		indices.push_back(first + index);
+	}
+#else
+	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+	SDL_RenderFillRect(renderer, &rect);
+	numDrawCalls++;
+#endif
+}
+
+void SpriteBatch::Flush(SDL_Renderer* renderer)
+{
+#ifdef SPRITE_BATCH_GEOMETRY
+	if (!indices.empty())
+	{
+		SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+		numDrawCalls++;
+	}
+#endif
+
+	vertices.clear();
+	indices.clear();
+	texture = nullptr;
+}
+
+int SpriteBatch::GetNumDrawCalls() const
+{
+	return numDrawCalls;
+}
+
+void SpriteBatch::ResetStats()
+{
+	numDrawCalls = 0;
+}
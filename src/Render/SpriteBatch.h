@@ -0,0 +1,47 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*---------------------------------------------------------------------------*/
+// SpriteBatch
+/*---------------------------------------------------------------------------*/
+// Collects the quads of consecutive sprites that share a texture, with the
+// rotation and the flip applied to their vertices, and draws each run with
+// one SDL_RenderGeometry call. The run is drawn when a sprite with another
+// texture is added, and by Flush, which must be called before anything is
+// drawn without the batch. Solid rectangles are batched like the sprites of
+// a texture. SDL versions without SDL_RenderGeometry get one
+// SDL_RenderCopyEx per sprite and one SDL_RenderFillRect per rectangle.
+/*---------------------------------------------------------------------------*/
+class SpriteBatch
+{
+private:
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+
+	SDL_Texture* texture = nullptr;
+	float textureWidth = 1.0f;
+	float textureHeight = 1.0f;
+
+	int numDrawCalls = 0;
+
+public:
+	SpriteBatch() = default;
+	~SpriteBatch() = default;
+
+	// The quad is rotated by angle degrees (clockwise) around the center of dstRect, like SDL_RenderCopyEx does
+	void Add(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& dstRect, double angle, SDL_RendererFlip flip, SDL_Color color = { 255, 255, 255, 255 });
+
+	// Filled with the color, in the same run as the other rectangles
+	void AddRect(SDL_Renderer* renderer, const SDL_Rect& rect, SDL_Color color);
+
+	void Flush(SDL_Renderer* renderer);
+
+	// Draw calls made since the last reset
+	int GetNumDrawCalls() const;
+	void ResetStats();
+};
+
+#endif
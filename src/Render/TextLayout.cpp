@@ -0,0 +1,29 @@
+#include "TextLayout.h"
+
+void TextLayout::Build(const GlyphAtlas& glyphAtlas, const std::string& text)
+{
+	quads.clear();
+
+	int penX = 0;
+	for (char c : text)
+	{
+		const Glyph& glyph = glyphAtlas.GetGlyph(c);
+		if (glyph.srcRect.w > 0)
+		{
+			quads.push_back({ glyph.srcRect, penX });
+		}
+		penX += glyph.advance;
+	}
+
+	width = penX;
+	height = glyphAtlas.GetLineHeight();
+}
+
+void TextLayout::Draw(RenderCommandList& commandList, const GlyphAtlas& glyphAtlas, int x, int y, SDL_Color color) const
+{
+	for (const auto& quad : quads)
+	{
+		SDL_Rect dstRect = { x + quad.x, y, quad.srcRect.w, quad.srcRect.h };
+		commandList.AddSprite(glyphAtlas.GetTexture(), quad.srcRect, dstRect, 0.0, SDL_FLIP_NONE, color);
+	}
+}
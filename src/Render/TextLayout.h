@@ -0,0 +1,39 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include "../AssetStore/GlyphAtlas.h"
+#include "RenderCommandList.h"
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*---------------------------------------------------------------------------*/
+// TextLayout
+/*---------------------------------------------------------------------------*/
+// The glyph quads of a single line of text, placed from its top left corner
+// with the advances of the glyph atlas. A layout is kept as long as its
+// text does not change, and recorded as glyph sprites at any position.
+/*---------------------------------------------------------------------------*/
+class TextLayout
+{
+private:
+	struct GlyphQuad
+	{
+		SDL_Rect srcRect;
+		int x;
+	};
+
+	std::vector<GlyphQuad> quads;
+	int width = 0;
+	int height = 0;
+
+public:
+	void Build(const GlyphAtlas& glyphAtlas, const std::string& text);
+
+	void Draw(RenderCommandList& commandList, const GlyphAtlas& glyphAtlas, int x, int y, SDL_Color color) const;
+
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "TilemapChunks.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+TilemapChunks::~TilemapChunks()
+{
+	DestroyChunks();
+}
+
+void TilemapChunks::SetTilemap(const Tilemap* tilemap, SDL_Texture* tileset, const SDL_Rect& tilesetRegion)
+{
+	DestroyChunks();
+
+	this->tilemap = tilemap;
+	this->tileset = tileset;
+	tilesetOffset = { tilesetRegion.x, tilesetRegion.y };
+}
+
+SDL_Rect TilemapChunks::GetTileSource(uint16_t tile) const
+{
+	SDL_Rect srcRect = tilemap->GetTileSource(tile);
+	srcRect.x += tilesetOffset.x;
+	srcRect.y += tilesetOffset.y;
+	return srcRect;
+}
+
+void TilemapChunks::Bake(SDL_Renderer* renderer)
+{
+	DestroyChunks();
+
+	if (!tilemap || !tileset || tilemap->GetTileset().tileSize <= 0 || !SDL_RenderTargetSupported(renderer))
+	{
+		return;
+	}
+
+	int numCols = tilemap->GetNumCols();
+	int numRows = tilemap->GetNumRows();
+	int tileSize = tilemap->GetTileset().tileSize;
+	numChunkCols = (numCols + chunkSize - 1) / chunkSize;
+	numChunkRows = (numRows + chunkSize - 1) / chunkSize;
+
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+	for (int chunkRow = 0; chunkRow < numChunkRows; chunkRow++)
+	{
+		for (int chunkCol = 0; chunkCol < numChunkCols; chunkCol++)
+		{
+			// The chunks on the right and bottom edges only hold the remaining tiles
+			int chunkNumCols = std::min(chunkSize, numCols - chunkCol * chunkSize);
+			int chunkNumRows = std::min(chunkSize, numRows - chunkRow * chunkSize);
+
+			SDL_Texture* chunk = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, chunkNumCols * tileSize, chunkNumRows * tileSize);
+			if (!chunk)
+			{
+				Logger::Err("Could not create a tilemap chunk texture: " + std::string(SDL_GetError()));
+				SDL_SetRenderTarget(renderer, previousTarget);
+				DestroyChunks();
+				return;
+			}
+
+			SDL_SetTextureBlendMode(chunk, SDL_BLENDMODE_BLEND);
+			SDL_SetRenderTarget(renderer, chunk);
+			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+			SDL_RenderClear(renderer);
+
+			for (int layer = 0; layer < tilemap->GetNumLayers(); layer++)
+			{
+				for (int y = 0; y < chunkNumRows; y++)
+				{
+					for (int x = 0; x < chunkNumCols; x++)
+					{
+						uint16_t tile = tilemap->GetTile(layer, chunkCol * chunkSize + x, chunkRow * chunkSize + y);
+						if (tile == EMPTY_TILE)
+						{
+							continue;
+						}
+
+						SDL_Rect srcRect = GetTileSource(tile);
+						SDL_Rect dstRect = { x * tileSize, y * tileSize, tileSize, tileSize };
+						SDL_RenderCopy(renderer, tileset, &srcRect, &dstRect);
+					}
+				}
+			}
+
+			chunkTextures.push_back(chunk);
+		}
+	}
+	SDL_SetRenderTarget(renderer, previousTarget);
+
+	Logger::Log("Tilemap baked into " + std::to_string(chunkTextures.size()) + " chunks");
+}
+
+void TilemapChunks::Clear()
+{
+	DestroyChunks();
+	tilemap = nullptr;
+	tileset = nullptr;
+	tilesetOffset = { 0, 0 };
+}
+
+void TilemapChunks::DestroyChunks()
+{
+	for (auto chunk : chunkTextures)
+	{
+		SDL_DestroyTexture(chunk);
+	}
+	chunkTextures.clear();
+	numChunkCols = numChunkRows = 0;
+}
+
+int TilemapChunks::GetNumChunks() const
+{
+	return static_cast<int>(chunkTextures.size());
+}
+
+int TilemapChunks::GetNumDrawCalls() const
+{
+	return numDrawCalls;
+}
+
+void TilemapChunks::Render(SDL_Renderer* renderer, const SDL_Rect& camera)
+{
+	numDrawCalls = 0;
+	if (chunkTextures.empty())
+	{
+		RenderTiles(renderer, camera);
+		return;
+	}
+
+	int numCols = tilemap->GetNumCols();
+	int numRows = tilemap->GetNumRows();
+	float tileWorldSize = tilemap->GetTileWorldSize();
+	float chunkWorldSize = chunkSize * tileWorldSize;
+	int firstChunkCol = std::max(static_cast<int>(std::floor(camera.x / chunkWorldSize)), 0);
+	int firstChunkRow = std::max(static_cast<int>(std::floor(camera.y / chunkWorldSize)), 0);
+	int lastChunkCol = std::min(static_cast<int>(std::floor((camera.x + camera.w) / chunkWorldSize)), numChunkCols - 1);
+	int lastChunkRow = std::min(static_cast<int>(std::floor((camera.y + camera.h) / chunkWorldSize)), numChunkRows - 1);
+
+	for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++)
+	{
+		for (int chunkCol = firstChunkCol; chunkCol <= lastChunkCol; chunkCol++)
+		{
+			int chunkNumCols = std::min(chunkSize, numCols - chunkCol * chunkSize);
+			int chunkNumRows = std::min(chunkSize, numRows - chunkRow * chunkSize);
+
+			// Rounded like the tiles were, so the chunk edges do not leave gaps
+			int x = static_cast<int>(chunkCol * chunkWorldSize) - camera.x;
+			int y = static_cast<int>(chunkRow * chunkWorldSize) - camera.y;
+			SDL_Rect dstRect = {
+				x,
+				y,
+				static_cast<int>((chunkCol * chunkSize + chunkNumCols) * tileWorldSize) - camera.x - x,
+				static_cast<int>((chunkRow * chunkSize + chunkNumRows) * tileWorldSize) - camera.y - y
+			};
+
+			SDL_RenderCopy(renderer, chunkTextures[chunkRow * numChunkCols + chunkCol], NULL, &dstRect);
+			numDrawCalls++;
+		}
+	}
+}
+
+// Fallback for renderers without render targets: only the tiles overlapping the camera are drawn
+void TilemapChunks::RenderTiles(SDL_Renderer* renderer, const SDL_Rect& camera)
+{
+	if (!tilemap || !tileset)
+	{
+		return;
+	}
+
+	float tileWorldSize = tilemap->GetTileWorldSize();
+	for (int layer = 0; layer < tilemap->GetNumLayers(); layer++)
+	{
+		tilemap->ForEachVisibleTile(layer, camera, [&](int col, int row, uint16_t tile) {
+			SDL_Rect srcRect = GetTileSource(tile);
+			SDL_Rect dstRect = {
+				static_cast<int>(col * tileWorldSize) - camera.x,
+				static_cast<int>(row * tileWorldSize) - camera.y,
+				static_cast<int>(tileWorldSize),
+				static_cast<int>(tileWorldSize)
+			};
+			SDL_RenderCopy(renderer, tileset, &srcRect, &dstRect);
+			numDrawCalls++;
+		});
+	}
+}
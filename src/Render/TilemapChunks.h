@@ -0,0 +1,59 @@
+#ifndef TILEMAP_CHUNKS_H
+#define TILEMAP_CHUNKS_H
+
+#include "../Tilemap/Tilemap.h"
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*---------------------------------------------------------------------------*/
+// TilemapChunks
+/*---------------------------------------------------------------------------*/
+// The layers of the level tilemap baked at load time into render target
+// textures of chunkSize x chunkSize tiles. A frame draws the chunks
+// overlapping the camera with one copy each, whatever the size of the map.
+// The tilemap is used again to bake the chunks when the renderer loses its
+// targets, and to draw the visible tiles one by one if it has no render
+// targets at all.
+/*---------------------------------------------------------------------------*/
+class TilemapChunks
+{
+private:
+	const Tilemap* tilemap = nullptr;
+	SDL_Texture* tileset = nullptr;
+	SDL_Point tilesetOffset = { 0, 0 };
+
+	SDL_Rect GetTileSource(uint16_t tile) const;
+
+	int chunkSize = 16;
+	int numChunkCols = 0;
+	int numChunkRows = 0;
+	std::vector<SDL_Texture*> chunkTextures;
+
+	// Copies made by the last Render
+	int numDrawCalls = 0;
+
+	void DestroyChunks();
+	void RenderTiles(SDL_Renderer* renderer, const SDL_Rect& camera);
+
+public:
+	TilemapChunks() = default;
+	~TilemapChunks();
+
+	TilemapChunks(const TilemapChunks&) = delete;
+	TilemapChunks& operator=(const TilemapChunks&) = delete;
+
+	// The tilemap must outlive the chunks, or be cleared from them first
+	// The tileset may be a region of an atlas page
+	void SetTilemap(const Tilemap* tilemap, SDL_Texture* tileset, const SDL_Rect& tilesetRegion);
+
+	// Renders the tiles into the chunk textures; also called when the renderer reports its targets were reset
+	void Bake(SDL_Renderer* renderer);
+	void Clear();
+
+	int GetNumChunks() const;
+	int GetNumDrawCalls() const;
+
+	void Render(SDL_Renderer* renderer, const SDL_Rect& camera);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define ANIMATION_SYSTEM_H
 
 #include "../ECS/ECS.h"
+#include "../Game/GameClock.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/SpriteComponent.h"
 #include <SDL2/SDL.h>
@@ -22,7 +23,7 @@ public:
 			auto& animation = entity.GetComponent<AnimationComponent>();
 			auto& sprite = entity.GetComponent<SpriteComponent>();
 
-			animation.currentFrame = ((SDL_GetTicks() - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
+			animation.currentFrame = ((GameClock::GetTicks() - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
 			sprite.srcRect.x = animation.currentFrame * sprite.width;
 		}
 	}
@@ -3,73 +3,542 @@
 
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
-#include "../Events/CollisionEvent.h"
+#include "../Events/CollisionEnterEvent.h"
+#include "../Events/CollisionStayEvent.h"
+#include "../Events/CollisionExitEvent.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/ScriptComponent.h"
+#include "../Collision/AABB.h"
+#include "../Collision/Broadphase.h"
+#include "../Collision/DynamicAABBTree.h"
+#include "../Collision/SpatialHashGrid.h"
+#include "../Collision/DynamicTreeBroadphase.h"
+#include "../Collision/SweepAndPrune.h"
+#include "../Collision/OverlapKernel.h"
+#include "../Collision/CollisionDispatcher.h"
+#include "../Collision/SpatialIndex.h"
+#include "../Threading/ThreadPool.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+enum BroadphaseType
+{
+	BROADPHASE_SPATIAL_GRID,
+	BROADPHASE_DYNAMIC_TREE,
+	BROADPHASE_SWEEP_AND_PRUNE
+};
+
+// Names used to select the broadphase in the level "collision" table
+static const char* const broadphaseNames[] = { "spatial_grid", "dynamic_tree", "sweep_and_prune" };
+
+// Collision timings and counters, smoothed over the last frames
+struct CollisionStats
+{
+	// Moving averages, and the timings of the last update alone
+	double broadphaseMilliseconds = 0.0;
+	double narrowphaseMilliseconds = 0.0;
+	double lastBroadphaseMilliseconds = 0.0;
+	double lastNarrowphaseMilliseconds = 0.0;
+	int numColliders = 0;
+	int numStaticColliders = 0;
+	int numCandidatePairs = 0;
+	int numCollisions = 0;
+	int numContactsEntered = 0;
+	int numContactsExited = 0;
+	int numNarrowphaseTasks = 0;
+};
+
+// Scratch buffers of one narrowphase task
+struct NarrowphaseTask
+{
+	std::vector<CollisionPair> contacts;
+	AABBArrays boxes;
+	std::vector<uint32_t> hitMask;
+};
 
 class CollisionSystem : public System
 {
+private:
+	BroadphaseType broadphaseType = BROADPHASE_SPATIAL_GRID;
+	std::unique_ptr<IBroadphase> broadphase;
+	float cellSize = 64.0f;
+	float fatMargin = 8.0f;
+
+	// Set when the dynamic tree is the active broadphase, to serve overlap and ray queries
+	DynamicTreeBroadphase* dynamicTree = nullptr;
+
+	// Colliders without a rigidbody (or a script to move them) never move. They are kept out of the
+	// broadphase and indexed once in a tree, which is rebuilt only when a static collider is added or killed
+	std::vector<Entity> dynamicEntities;
+	std::vector<Entity> staticEntities;
+	std::vector<ColliderProxy> staticProxies;
+	DynamicAABBTree staticIndex;
+	bool staticIndexDirty = false;
+
+	// Boxes of the dynamic colliders gathered this frame, in the same order as dynamicEntities
+	std::vector<ColliderProxy> proxies;
+	std::vector<CollisionPair> candidatePairs;
+
+	// Overlapping pairs of the current and the previous update, sorted; comparing them tells
+	// which contacts started (enter), continued (stay) or ended (exit) in this update
+	std::vector<CollisionPair> contacts;
+	std::vector<CollisionPair> previousContacts;
+	bool emitStayEvents = false;
+
+	// Handlers of the new contacts, per pair of groups
+	CollisionDispatcher dispatcher;
+
+	// Boxes of all the colliders, static and dynamic, for the queries of the other systems and the scripts
+	SpatialIndex spatialIndex;
+
+	// [Vector index = entity id]
+	// [Vector value = index in the proxies (or staticProxies) vector]
+	std::vector<int> proxyIndexPerEntity;
+	std::vector<bool> isStaticEntity;
+
+	// Continuous colliders are swept from their box of the previous update to the current one,
+	// so fast colliders can not skip over a box between two updates
+	// [Vector index = entity id]
+	std::vector<AABB> boxPerEntity;
+	std::vector<AABB> previousBoxPerEntity;
+	std::vector<bool> isContinuousEntity;
+	std::vector<bool> hasPreviousBox;
+
+	static bool IsStatic(Entity entity)
+	{
+		return !entity.HasComponent<RigidBodyComponent>() && !entity.HasComponent<ScriptComponent>();
+	}
+
+	void RebuildStaticIndex()
+	{
+		staticIndex.Clear();
+		staticProxies.clear();
+
+		for (auto entity : staticEntities)
+		{
+			const auto& transform = entity.GetComponent<TransformComponent>();
+			const auto& collider = entity.GetComponent<BoxColliderComponent>();
+
+			AABB box = GetColliderBox(transform, collider);
+			boxPerEntity[entity.GetId()] = box;
+			previousBoxPerEntity[entity.GetId()] = box;
+			isContinuousEntity[entity.GetId()] = false;
+
+			proxyIndexPerEntity[entity.GetId()] = static_cast<int>(staticProxies.size());
+			staticProxies.push_back({ entity.GetId(), box, collider.layer, collider.mask });
+			staticIndex.CreateProxy(box, entity.GetId());
+			spatialIndex.SetBox(entity.GetId(), box, collider.layer);
+		}
+
+		staticIndexDirty = false;
+		Logger::Log("Static collision index rebuilt with " + std::to_string(staticProxies.size()) + " colliders");
+	}
+
+	const ColliderProxy& GetProxy(int entityId) const
+	{
+		return isStaticEntity[entityId] ? staticProxies[proxyIndexPerEntity[entityId]] : proxies[proxyIndexPerEntity[entityId]];
+	}
+
+	Entity GetColliderEntity(int entityId) const
+	{
+		return isStaticEntity[entityId] ? staticEntities[proxyIndexPerEntity[entityId]] : dynamicEntities[proxyIndexPerEntity[entityId]];
+	}
+
+	// Tests the boxes of two colliders over their motion since the last update, for pairs with a continuous collider
+	bool SweptOverlap(int entityA, int entityB) const
+	{
+		const AABB& fromA = previousBoxPerEntity[entityA];
+		const AABB& fromB = previousBoxPerEntity[entityB];
+		const AABB& toA = boxPerEntity[entityA];
+		const AABB& toB = boxPerEntity[entityB];
+
+		// Motion of a as seen from b
+		float deltaX = (toA.minX - fromA.minX) - (toB.minX - fromB.minX);
+		float deltaY = (toA.minY - fromA.minY) - (toB.minY - fromB.minY);
+		if (deltaX == 0.0f && deltaY == 0.0f)
+		{
+			return toA.Overlaps(toB);
+		}
+
+		// The boxes overlap while the top-left corner of a is inside of b grown by the size of a
+		AABB grownB(fromB.minX - (fromA.maxX - fromA.minX), fromB.minY - (fromA.maxY - fromA.minY), fromB.maxX, fromB.maxY);
+		float entryFraction;
+		return grownB.IntersectsSegment(fromA.minX, fromA.minY, fromA.minX + deltaX, fromA.minY + deltaY, entryFraction);
+	}
+
+	static void AddContacts(Entity entity, int numContacts)
+	{
+		auto& collider = entity.GetComponent<BoxColliderComponent>();
+		collider.numContacts += numContacts;
+		collider.collision = collider.numContacts > 0;
+	}
+
+	// The candidate pairs are split in contiguous ranges tested by the pool threads, each one writing
+	// the colliding pairs to its own buffer; the buffers are read back in range order, so the events
+	// come out in the same order as in a single-threaded run
+	ThreadPool threadPool;
+	bool multithreadedNarrowphase = true;
+	std::vector<NarrowphaseTask> narrowphaseTasks;
+	static const int minPairsPerTask = 256;
+
+	CollisionStats stats;
+
+	static double MillisecondsSince(Uint64 startCounter)
+	{
+		return (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+	}
+
 public:
-	CollisionSystem()
+	CollisionSystem(): staticIndex(0.0f)
 	{
 		RequireComponent<TransformComponent>();
 		RequireComponent<BoxColliderComponent>();
+
+		SetBroadphase(BROADPHASE_SPATIAL_GRID);
+	}
+
+	void AddEntityToSystem(Entity entity) override
+	{
+		System::AddEntityToSystem(entity);
+
+		int entityId = entity.GetId();
+		if (entityId >= static_cast<int>(isStaticEntity.size()))
+		{
+			isStaticEntity.resize(entityId + 1, false);
+			proxyIndexPerEntity.resize(entityId + 1, -1);
+			boxPerEntity.resize(entityId + 1);
+			previousBoxPerEntity.resize(entityId + 1);
+			isContinuousEntity.resize(entityId + 1, false);
+			hasPreviousBox.resize(entityId + 1, false);
+		}
+		hasPreviousBox[entityId] = false;
+
+		isStaticEntity[entityId] = IsStatic(entity);
+		if (isStaticEntity[entityId])
+		{
+			staticEntities.push_back(entity);
+			staticIndexDirty = true;
+		}
+		else
+		{
+			dynamicEntities.push_back(entity);
+		}
+	}
+
+	void RemoveEntityFromSystem(Entity entity) override
+	{
+		System::RemoveEntityFromSystem(entity);
+
+		auto isEntity = [&entity](Entity other) { return entity == other; };
+		int entityId = entity.GetId();
+		spatialIndex.Remove(entityId);
+		if (entityId < static_cast<int>(isStaticEntity.size()) && isStaticEntity[entityId])
+		{
+			auto last = std::remove_if(staticEntities.begin(), staticEntities.end(), isEntity);
+			if (last != staticEntities.end())
+			{
+				staticEntities.erase(last, staticEntities.end());
+				isStaticEntity[entityId] = false;
+				staticIndexDirty = true;
+			}
+		}
+		else
+		{
+			dynamicEntities.erase(std::remove_if(dynamicEntities.begin(), dynamicEntities.end(), isEntity), dynamicEntities.end());
+		}
+
+		// The contacts of a killed collider are dropped without an exit event, as its components are going away
+		if (entity.HasComponent<BoxColliderComponent>() && entity.GetComponent<BoxColliderComponent>().numContacts > 0)
+		{
+			contacts.erase(std::remove_if(contacts.begin(), contacts.end(), [&](const CollisionPair& pair) {
+				if (pair.a != entityId && pair.b != entityId)
+				{
+					return false;
+				}
+				// The entity vectors may have changed since the last update, so the other collider is not looked up in them
+				Entity other(pair.a == entityId ? pair.b : pair.a);
+				other.registry = entity.registry;
+				AddContacts(other, -1);
+				return true;
+				}), contacts.end());
+		}
+	}
+
+	// Cell size (in pixels) used by the spatial hash grid broadphase
+	void SetSpatialGridCellSize(float cellSize)
+	{
+		this->cellSize = cellSize;
+	}
+
+	// Margin (in pixels) the dynamic tree broadphase adds around every box
+	void SetDynamicTreeMargin(float fatMargin)
+	{
+		this->fatMargin = fatMargin;
+	}
+
+	// Switch the broadphase; it will be filled again with the colliders in the next update
+	void SetBroadphase(BroadphaseType type)
+	{
+		broadphaseType = type;
+		dynamicTree = nullptr;
+
+		switch (type)
+		{
+			case BROADPHASE_DYNAMIC_TREE:
+			{
+				auto tree = std::make_unique<DynamicTreeBroadphase>(fatMargin);
+				dynamicTree = tree.get();
+				broadphase = std::move(tree);
+				break;
+			}
+
+			case BROADPHASE_SWEEP_AND_PRUNE:
+				broadphase = std::make_unique<SweepAndPrune>();
+				break;
+
+			default:
+				broadphase = std::make_unique<SpatialHashGrid>(cellSize);
+				break;
+		}
+
+		stats = CollisionStats();
+		Logger::Log("Collision broadphase set to " + std::string(broadphaseNames[type]));
+	}
+
+	void SetMultithreadedNarrowphase(bool multithreaded)
+	{
+		multithreadedNarrowphase = multithreaded;
+	}
+
+	bool IsNarrowphaseMultithreaded() const
+	{
+		return multithreadedNarrowphase;
+	}
+
+	// Emit a CollisionStayEvent on every update for the pairs that keep overlapping
+	void SetEmitStayEvents(bool emitStayEvents)
+	{
+		this->emitStayEvents = emitStayEvents;
+	}
+
+	CollisionDispatcher& GetDispatcher()
+	{
+		return dispatcher;
+	}
+
+	BroadphaseType GetBroadphaseType() const
+	{
+		return broadphaseType;
+	}
+
+	const CollisionStats& GetStats() const
+	{
+		return stats;
+	}
+
+	// Holds the collider boxes of the last update, whatever the broadphase
+	const SpatialIndex& GetSpatialIndex() const
+	{
+		return spatialIndex;
+	}
+
+	// Returns the tree of the last update, or nullptr if the dynamic tree is not the active broadphase
+	const DynamicAABBTree* GetDynamicTree() const
+	{
+		return dynamicTree ? &dynamicTree->GetTree() : nullptr;
 	}
 
 	void Update(std::unique_ptr<EventBus>& eventBus)
 	{
-		// Check all entities that have a boxcollider
-		// to see if they are colliding with each other
-		auto entities = GetSystemEntities();
+		if (staticIndexDirty)
+		{
+			RebuildStaticIndex();
+		}
 
-		for (auto i = entities.begin(); i != entities.end(); i++)
+		// Gather the world-space box of every dynamic collider; the broadphase gets the
+		// box swept since the last update for the continuous ones
+		proxies.clear();
+		for (auto entity : dynamicEntities)
 		{
-			Entity a = *i;
-			auto aTransform = a.GetComponent<TransformComponent>();
-			auto& aCollider = a.GetComponent<BoxColliderComponent>();
+			const auto& transform = entity.GetComponent<TransformComponent>();
+			const auto& collider = entity.GetComponent<BoxColliderComponent>();
+			int entityId = entity.GetId();
+
+			AABB box = GetColliderBox(transform, collider);
+			previousBoxPerEntity[entityId] = hasPreviousBox[entityId] ? boxPerEntity[entityId] : box;
+			boxPerEntity[entityId] = box;
+			hasPreviousBox[entityId] = true;
+			isContinuousEntity[entityId] = collider.continuous;
 
-			for (auto j = i + 1; j != entities.end(); j++)
+			proxyIndexPerEntity[entityId] = static_cast<int>(proxies.size());
+			proxies.push_back({ entityId, collider.continuous ? AABB::Union(previousBoxPerEntity[entityId], box) : box, collider.layer, collider.mask });
+			spatialIndex.SetBox(entityId, box, collider.layer);
+		}
+
+		// Let the broadphase find the dynamic pairs that are close enough to be tested and whose
+		// layers can collide, and sort them so the events are emitted in the same order every frame
+		Uint64 broadphaseStart = SDL_GetPerformanceCounter();
+		candidatePairs.clear();
+		broadphase->ComputePairs(proxies, candidatePairs);
+
+		// Dynamic colliders are paired with the static ones from the static index; static pairs are never tested
+		if (!staticProxies.empty())
+		{
+			for (const auto& proxy : proxies)
+			{
+				staticIndex.Query(proxy.box, [&](int staticEntityId) {
+					const auto& staticProxy = staticProxies[proxyIndexPerEntity[staticEntityId]];
+					if (CanCollide(proxy.layer, proxy.mask, staticProxy.layer, staticProxy.mask))
+					{
+						candidatePairs.emplace_back(proxy.entityId, staticEntityId);
+					}
+					return true;
+				});
+			}
+		}
+
+		std::sort(candidatePairs.begin(), candidatePairs.end());
+		candidatePairs.erase(std::unique(candidatePairs.begin(), candidatePairs.end()), candidatePairs.end());
+		double broadphaseMilliseconds = MillisecondsSince(broadphaseStart);
+
+		// Narrowphase: check the candidate pairs to see if they are colliding with each other
+		Uint64 narrowphaseStart = SDL_GetPerformanceCounter();
+		int numPairs = static_cast<int>(candidatePairs.size());
+		int numTasks = 1;
+		if (multithreadedNarrowphase)
+		{
+			numTasks = std::max(1, std::min(threadPool.GetNumThreads(), numPairs / minPairsPerTask));
+		}
+		if (static_cast<int>(narrowphaseTasks.size()) < numTasks)
+		{
+			narrowphaseTasks.resize(numTasks);
+		}
+
+		threadPool.ParallelFor(numTasks, [&](int task) {
+			auto& narrowphaseTask = narrowphaseTasks[task];
+			narrowphaseTask.contacts.clear();
+
+			int first = static_cast<int>(static_cast<long long>(numPairs) * task / numTasks);
+			int last = static_cast<int>(static_cast<long long>(numPairs) * (task + 1) / numTasks);
+
+			// The pairs are sorted, so the pairs of one collider follow each other: its box is
+			// tested against the boxes of all of them at once with the SIMD overlap kernel
+			while (first < last)
 			{
-				Entity b = *j;
-				auto bTransform = b.GetComponent<TransformComponent>();
-				auto& bCollider = b.GetComponent<BoxColliderComponent>();
-
-				bool haveCollision = Check_AABB_Collision(
-					aTransform.position.x + aCollider.offset.x,
-					aTransform.position.y + aCollider.offset.y,
-					aCollider.width * aTransform.scale.x,
-					aCollider.height * aTransform.scale.y,
-					bTransform.position.x + bCollider.offset.x,
-					bTransform.position.y + bCollider.offset.y, 
-					bCollider.width * bTransform.scale.x,
-					bCollider.height * bTransform.scale.y
-				);
-
-				if (haveCollision)
+				int colliderId = candidatePairs[first].a;
+				int runEnd = first;
+
+				narrowphaseTask.boxes.Clear();
+				while (runEnd < last && candidatePairs[runEnd].a == colliderId)
+				{
+					narrowphaseTask.boxes.Add(GetProxy(candidatePairs[runEnd].b).box);
+					runEnd++;
+				}
+
+				narrowphaseTask.hitMask.resize((runEnd - first + 31) / 32);
+				OverlapKernel::ComputeOverlapMask(GetProxy(colliderId).box, narrowphaseTask.boxes, narrowphaseTask.hitMask.data());
+
+				for (int i = first; i < runEnd; i++)
 				{
-					aCollider.collision = true;
-					bCollider.collision = true;
-					//Logger::Log("Collision detected between entity id " + std::to_string(a.GetId()) + " and entity id " + std::to_string(b.GetId()));
-					
-					eventBus->EmitEvent<CollisionEvent>(a, b);
+					if (!(narrowphaseTask.hitMask[(i - first) >> 5] & (1u << ((i - first) & 31))))
+					{
+						continue;
+					}
+
+					// The swept boxes of continuous colliders overlap; check they met along the way
+					const auto& pair = candidatePairs[i];
+					if ((isContinuousEntity[pair.a] || isContinuousEntity[pair.b]) && !SweptOverlap(pair.a, pair.b))
+					{
+						continue;
+					}
+
+					narrowphaseTask.contacts.push_back(pair);
 				}
-				else
+
+				first = runEnd;
+			}
+		});
+		double narrowphaseMilliseconds = MillisecondsSince(narrowphaseStart);
+
+		// Gather the contacts in candidate pair order (so they come out sorted), and compare them
+		// with the previous ones to update the contact counts and emit the events on this thread
+		previousContacts.swap(contacts);
+		contacts.clear();
+		for (int task = 0; task < numTasks; task++)
+		{
+			contacts.insert(contacts.end(), narrowphaseTasks[task].contacts.begin(), narrowphaseTasks[task].contacts.end());
+		}
+
+		int numEntered = 0;
+		int numExited = 0;
+		auto current = contacts.begin();
+		auto previous = previousContacts.begin();
+		while (current != contacts.end() || previous != previousContacts.end())
+		{
+			if (previous == previousContacts.end() || (current != contacts.end() && *current < *previous))
+			{
+				Entity a = GetColliderEntity(current->a);
+				Entity b = GetColliderEntity(current->b);
+				AddContacts(a, 1);
+				AddContacts(b, 1);
+				numEntered++;
+				//Logger::Log("Collision detected between entity id " + std::to_string(a.GetId()) + " and entity id " + std::to_string(b.GetId()));
+
+				dispatcher.Dispatch(a, b);
+				eventBus->EmitEvent<CollisionEnterEvent>(a, b);
+				current++;
+			}
+			else if (current == contacts.end() || *previous < *current)
+			{
+				Entity a = GetColliderEntity(previous->a);
+				Entity b = GetColliderEntity(previous->b);
+				AddContacts(a, -1);
+				AddContacts(b, -1);
+				numExited++;
+
+				eventBus->EmitEvent<CollisionExitEvent>(a, b);
+				previous++;
+			}
+			else
+			{
+				if (emitStayEvents)
 				{
-					aCollider.collision = false;
-					bCollider.collision = false;
+					eventBus->EmitEvent<CollisionStayEvent>(GetColliderEntity(current->a), GetColliderEntity(current->b));
 				}
+				current++;
+				previous++;
 			}
 		}
+
+		// The batch handlers get all the contacts entered this frame at once
+		dispatcher.Flush();
+
+		// Keep a moving average of the timings, to compare the broadphases on a level
+		const double smoothing = 0.05;
+		stats.broadphaseMilliseconds += (broadphaseMilliseconds - stats.broadphaseMilliseconds) * smoothing;
+		stats.narrowphaseMilliseconds += (narrowphaseMilliseconds - stats.narrowphaseMilliseconds) * smoothing;
+		stats.lastBroadphaseMilliseconds = broadphaseMilliseconds;
+		stats.lastNarrowphaseMilliseconds = narrowphaseMilliseconds;
+		stats.numColliders = static_cast<int>(proxies.size() + staticProxies.size());
+		stats.numStaticColliders = static_cast<int>(staticProxies.size());
+		stats.numCandidatePairs = static_cast<int>(candidatePairs.size());
+		stats.numCollisions = static_cast<int>(contacts.size());
+		stats.numContactsEntered = numEntered;
+		stats.numContactsExited = numExited;
+		stats.numNarrowphaseTasks = numTasks;
 	}
 
-	bool Check_AABB_Collision(double aX, double aY, double aW, double aH, double bX, double bY, double bW, double bH)
+	static AABB GetColliderBox(const TransformComponent& transform, const BoxColliderComponent& collider)
 	{
-		return (
-			aX < bX + bW &&
-			aX + aW > bX &&
-			aY < bY + bH &&
-			aY + aH > bY
-			);	
+		float x = transform.position.x + collider.offset.x;
+		float y = transform.position.y + collider.offset.y;
+
+		return AABB(x, y, x + collider.width * transform.scale.x, y + collider.height * transform.scale.y);
 	}
 };
 
@@ -5,8 +5,7 @@
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/ProjectileComponent.h"
 #include "../Components/HealthComponent.h"
-#include "../EventBus/EventBus.h"
-#include "../Events/CollisionEvent.h"
+#include "CollisionSystem.h"
 
 class DamageSystem : public System
 {
@@ -17,36 +16,12 @@ public:
 		RequireComponent<BoxColliderComponent>();
 	}
 
-	void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus)
+	// The collision system calls the handlers with the entities in the order of the groups
+	void SubscribeToCollisions(std::unique_ptr<Registry>& registry)
 	{
-		eventBus->SubsrcibeToEvent<CollisionEvent>(this, &DamageSystem::OnCollision);
-	}
-
-	void OnCollision(CollisionEvent& event)
-	{
-		Entity a = event.a;
-		Entity b = event.b;
-		//Logger::Log("Collision event emitted: " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
-
-		if (a.BelongsToGroup("projectiles") && b.HasTag("player"))
-		{
-			OnProjectileHitsPlayer(a, b); // "a" is the projectile, "b" is the player
-		}
-
-		if (b.BelongsToGroup("projectiles") && a.HasTag("player"))
-		{
-			OnProjectileHitsPlayer(b, a); // "b" is the projectile, "a" is the player
-		}
-
-		if (a.BelongsToGroup("projectiles") && b.BelongsToGroup("enemies"))
-		{
-			OnProjectileHitsEnemy(a, b); // "a" is the projectile, "b" is the enemy
-		}
-
-		if (b.BelongsToGroup("projectiles") && a.BelongsToGroup("enemies"))
-		{
-			OnProjectileHitsEnemy(b, a); // "b" is the projectile, "a" is the enemy
-		}
+		auto& dispatcher = registry->GetSystem<CollisionSystem>().GetDispatcher();
+		dispatcher.AddHandler<&DamageSystem::OnProjectileHitsPlayer>(registry->GetGroupId("projectiles"), registry->GetGroupId("player"), this);
+		dispatcher.AddBatchHandler<&DamageSystem::OnProjectilesHitEnemies>(registry->GetGroupId("projectiles"), registry->GetGroupId("enemies"), this);
 	}
 
 	void OnProjectileHitsPlayer(Entity projectile, Entity player)
@@ -70,23 +45,27 @@ public:
 		}
 	}
 
-	void OnProjectileHitsEnemy(Entity projectile, Entity enemy)
+	// All the hits of the frame, with a being the projectile and b the enemy
+	void OnProjectilesHitEnemies(EventSpan<CollisionEnterEvent> hits)
 	{
-		auto projectileComponent = projectile.GetComponent<ProjectileComponent>();
-
-		if (projectileComponent.isFriendly)
+		for (auto& hit : hits)
 		{
-			// Reduce the health of the player by the projectile hitPercentDamage
-			auto& health = enemy.GetComponent<HealthComponent>();
-			health.healthPercentage -= projectileComponent.hitPercentDamage;
+			const auto& projectileComponent = hit.a.GetComponent<ProjectileComponent>();
 
-			if (health.healthPercentage <= 0)
+			if (projectileComponent.isFriendly)
 			{
-				enemy.Kill();
-			}
+				// Reduce the health of the enemy by the projectile hitPercentDamage
+				auto& health = hit.b.GetComponent<HealthComponent>();
+				health.healthPercentage -= projectileComponent.hitPercentDamage;
 
-			// Kill the projectile
-			projectile.Kill();
+				if (health.healthPercentage <= 0)
+				{
+					hit.b.Kill();
+				}
+
+				// Kill the projectile
+				hit.a.Kill();
+			}
 		}
 	}
 
@@ -22,7 +22,7 @@ public:
 
 	void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus)
 	{
-		eventBus->SubsrcibeToEvent<KeyPressedEvent>(this, &KeyboardControlSystem::OnKeyPressed);
+		eventBus->SubscribeToEvent<&KeyboardControlSystem::OnKeyPressed>(this);
 	}
 
 	void OnKeyPressed(KeyPressedEvent& event)
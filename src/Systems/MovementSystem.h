@@ -2,14 +2,20 @@
 #define MOVEMENT_SYSTEM_H
 
 #include "../ECS/ECS.h"
-#include "../EventBus/EventBus.h"
-#include "../Events/CollisionEvent.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Collision/TileCollisionGrid.h"
+#include "CollisionSystem.h"
 
 class MovementSystem: public System
 {
+private:
+	// Resolved once when subscribing, so the solid tile checks compare ids instead of group names
+	int projectilesGroupId = -1;
+	int enemiesGroupId = -1;
+
 public:
 	MovementSystem()
 	{
@@ -17,26 +23,14 @@ public:
 		RequireComponent<RigidBodyComponent>();
 	}
 
-	void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus)
+	// The collision system calls the handler with the enemy first
+	void SubscribeToCollisions(std::unique_ptr<Registry>& registry)
 	{
-		eventBus->SubsrcibeToEvent<CollisionEvent>(this, &MovementSystem::OnCollision);
-	}
+		projectilesGroupId = registry->GetGroupId("projectiles");
+		enemiesGroupId = registry->GetGroupId("enemies");
 
-	void OnCollision(CollisionEvent& event)
-	{
-		Entity a = event.a;
-		Entity b = event.b;
-		//Logger::Log("Collision event emitted: " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
-
-		if (a.BelongsToGroup("enemies") && b.BelongsToGroup("obstacles"))
-		{	
-			OnEnemyHitsObstacle(a, b); // "a" is the enemy and "b" is the obstacle
-		}
-		
-		if (a.BelongsToGroup("obstacles") && b.BelongsToGroup("enemies"))
-		{
-			OnEnemyHitsObstacle(b, a); // "b" is the enemy and "a" is the obstacle
-		}
+		auto& dispatcher = registry->GetSystem<CollisionSystem>().GetDispatcher();
+		dispatcher.AddHandler<&MovementSystem::OnEnemyHitsObstacle>(enemiesGroupId, registry->GetGroupId("obstacles"), this);
 	}
 
 	void OnEnemyHitsObstacle(Entity enemy, Entity obstacle)
@@ -61,7 +55,62 @@ public:
 
 	}
 
-	void Update(double deltaTime)
+	static bool CollidesWithTerrain(const BoxColliderComponent& collider, const std::unique_ptr<TileCollisionGrid>& tileCollisionGrid)
+	{
+		return CanCollide(tileCollisionGrid->GetLayer(), tileCollisionGrid->GetMask(), collider.layer, collider.mask);
+	}
+
+	// Keeps a collider out of the solid tiles: projectiles are destroyed, the rest of the entities
+	// are moved back on the blocked axis, and enemies turn around like when they hit an obstacle
+	void OnEntityHitsSolidTiles(Entity entity, const glm::vec2& previousPosition, const std::unique_ptr<TileCollisionGrid>& tileCollisionGrid)
+	{
+		auto& transform = entity.GetComponent<TransformComponent>();
+		const auto& collider = entity.GetComponent<BoxColliderComponent>();
+		const int groupId = entity.GetGroupId();
+
+		if (groupId == projectilesGroupId)
+		{
+			entity.Kill();
+			return;
+		}
+
+		glm::vec2 newPosition = transform.position;
+
+		// Try the horizontal move alone, then add the vertical one
+		transform.position = glm::vec2(newPosition.x, previousPosition.y);
+		bool blockedX = tileCollisionGrid->OverlapsSolid(CollisionSystem::GetColliderBox(transform, collider));
+		if (blockedX)
+		{
+			transform.position.x = previousPosition.x;
+		}
+
+		transform.position.y = newPosition.y;
+		bool blockedY = tileCollisionGrid->OverlapsSolid(CollisionSystem::GetColliderBox(transform, collider));
+		if (blockedY)
+		{
+			transform.position.y = previousPosition.y;
+		}
+
+		if (groupId == enemiesGroupId && entity.HasComponent<SpriteComponent>())
+		{
+			auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+			auto& sprite = entity.GetComponent<SpriteComponent>();
+
+			if (blockedX && rigidBody.velocity.x != 0)
+			{
+				rigidBody.velocity.x *= -1;
+				sprite.flip = (sprite.flip == SDL_FLIP_NONE ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+			}
+
+			if (blockedY && rigidBody.velocity.y != 0)
+			{
+				rigidBody.velocity.y *= -1;
+				sprite.flip = (sprite.flip == SDL_FLIP_NONE ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE);
+			}
+		}
+	}
+
+	void Update(double deltaTime, const std::unique_ptr<TileCollisionGrid>& tileCollisionGrid)
 	{
 		// Loop all the entities the system is interested in
 		for (auto entity: GetSystemEntities())
@@ -69,10 +118,36 @@ public:
 			// Update entity position based on its velocity
 			auto& transform = entity.GetComponent<TransformComponent>();
 			const auto rigidBody = entity.GetComponent<RigidBodyComponent>();
+			const glm::vec2 previousPosition = transform.position;
 
 			transform.position.x += rigidBody.velocity.x * deltaTime;
 			transform.position.y += rigidBody.velocity.y * deltaTime;
 
+			// Check the colliders that collide with the terrain layer against the solid tiles of the tilemap,
+			// over the whole move for the continuous ones
+			if (tileCollisionGrid->HasSolidTiles() && entity.HasComponent<BoxColliderComponent>() && CollidesWithTerrain(entity.GetComponent<BoxColliderComponent>(), tileCollisionGrid))
+			{
+				const auto& collider = entity.GetComponent<BoxColliderComponent>();
+				AABB box = CollisionSystem::GetColliderBox(transform, collider);
+				bool hitsSolidTiles;
+				if (collider.continuous)
+				{
+					// Swept from the previous position, so a fast collider does not skip over a tile
+					glm::vec2 move = transform.position - previousPosition;
+					AABB previousBox(box.minX - move.x, box.minY - move.y, box.maxX - move.x, box.maxY - move.y);
+					hitsSolidTiles = tileCollisionGrid->SweepOverlapsSolid(previousBox, move.x, move.y);
+				}
+				else
+				{
+					hitsSolidTiles = tileCollisionGrid->OverlapsSolid(box);
+				}
+
+				if (hitsSolidTiles)
+				{
+					OnEntityHitsSolidTiles(entity, previousPosition, tileCollisionGrid);
+				}
+			}
+
 			// Prevent the main palyer from moving outside the map limits
 			if (entity.HasTag("player"))
 			{
@@ -2,6 +2,7 @@
 #define PROJECTILE_EMIT_SYSTEM_H
 
 #include "../ECS/ECS.h"
+#include "../Game/GameClock.h"
 #include "../EventBus/EventBus.h"
 #include "../Events/KeyPressedEvent.h"
 #include "../Components/ProjectileEmitterComponent.h"
@@ -15,6 +16,9 @@
 
 class ProjectileEmitSystem : public System
 {
+private:
+	TextureHandle projectileTexture = INVALID_ASSET_HANDLE;
+
 public:
 	ProjectileEmitSystem()
 	{
@@ -22,9 +26,15 @@ public:
 		RequireComponent<TransformComponent>();
 	}
 
+	// Resolved once the level assets are loaded
+	void SetProjectileTexture(TextureHandle texture)
+	{
+		projectileTexture = texture;
+	}
+
 	void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus)
 	{
-		eventBus->SubsrcibeToEvent<KeyPressedEvent>(this, &ProjectileEmitSystem::OnKeyPressed);
+		eventBus->SubscribeToEvent<&ProjectileEmitSystem::OnKeyPressed>(this);
 	}
 
 	void OnKeyPressed(KeyPressedEvent& event)
@@ -67,8 +77,8 @@ public:
 					projectile.Group("projectiles");
 					projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1, 1), 0.0);
 					projectile.AddComponent<RigidBodyComponent>(projectileVelocity);
-					projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-					projectile.AddComponent<BoxColliderComponent>(4, 4);
+					projectile.AddComponent<SpriteComponent>(projectileTexture, 4, 4, 4);
+					projectile.AddComponent<BoxColliderComponent>(4, 4, glm::vec2(0), projectileEmitter.projectileLayer, projectileEmitter.projectileMask, true);
 					projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
 				}
 			}
@@ -89,7 +99,7 @@ public:
 			}
 
 			// Check if it is time to emit a new projectile
-			if (SDL_GetTicks() - projectileEmitter.lastEmissionTime > projectileEmitter.repeatFrequency)
+			if (GameClock::GetTicks() - projectileEmitter.lastEmissionTime > projectileEmitter.repeatFrequency)
 			{
 				glm::vec2 projectilePosition = transform.position;
 
@@ -105,12 +115,12 @@ public:
 				projectile.Group("projectiles");
 				projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1, 1), 0.0);
 				projectile.AddComponent<RigidBodyComponent>(projectileEmitter.projectileVelocity);
-				projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-				projectile.AddComponent<BoxColliderComponent>(4, 4);
+				projectile.AddComponent<SpriteComponent>(projectileTexture, 4, 4, 4);
+				projectile.AddComponent<BoxColliderComponent>(4, 4, glm::vec2(0), projectileEmitter.projectileLayer, projectileEmitter.projectileMask, true);
 				projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
 
 				// Update the projectile emitter component last emission to the current milliseconds
-				projectileEmitter.lastEmissionTime = SDL_GetTicks();
+				projectileEmitter.lastEmissionTime = GameClock::GetTicks();
 			}
 		}
 	}
@@ -2,6 +2,7 @@
 #define PROJECTILE_LIFECYCLE_SYSTEM_H
 
 #include "../ECS/ECS.h"
+#include "../Game/GameClock.h"
 #include "../Components/ProjectileComponent.h"
 #include <SDL2/SDL.h>
 
@@ -19,7 +20,7 @@ public:
 		{
 			const auto projectile = entity.GetComponent<ProjectileComponent>();
 
-			if (SDL_GetTicks()  - projectile.startTime > projectile.duration)
+			if (GameClock::GetTicks()  - projectile.startTime > projectile.duration)
 			{
 				entity.Kill();
 			}
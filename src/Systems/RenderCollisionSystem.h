@@ -4,6 +4,7 @@
 #include "../ECS/ECS.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/BoxColliderComponent.h"
+#include "../Render/RenderCommandList.h"
 #include <SDL2/SDL.h>
 
 class RenderCollisionSystem: public System
@@ -15,7 +16,7 @@ public:
 		RequireComponent<BoxColliderComponent>();
 	}
 
-	void Update(SDL_Renderer* renderer, SDL_Rect& camera)
+	void Update(RenderCommandList& commandList, const SDL_Rect& camera)
 	{
 		// Loop all the entities the system is interested in
 		for (auto entity: GetSystemEntities())
@@ -31,8 +32,8 @@ public:
 				static_cast<int>(collider.height * transform.scale.y)
 			};
 
-			SDL_SetRenderDrawColor(renderer, (collider.collision ? 255 : 0), (collider.collision ? 0 : 255) , 0, 255);
-			SDL_RenderDrawRect(renderer,&boundingBox);
+			SDL_Color color = { static_cast<Uint8>(collider.collision ? 255 : 0), static_cast<Uint8>(collider.collision ? 0 : 255), 0, 255 };
+			commandList.AddDrawRect(boundingBox, color);
 		}
 	}
 };
@@ -9,6 +9,7 @@
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/HealthComponent.h"
+#include "CollisionSystem.h"
 #include <glm/glm.hpp>
 #include <imgui.h>
 #include <imgui_impl_sdl.h>
@@ -18,6 +19,13 @@
 #include <SDL2/SDL.h>
 
 
+// Item getter for the combos listing the collision layers of the level
+static bool GetCollisionLayerName(void* data, int index, const char** name)
+{
+	*name = CollisionLayers::GetLayerName(index).c_str();
+	return true;
+}
+
 // Helper to display a little (?) mark which shows a tooltip when hovered.
 // In your own code you may want to display an actual icon if you are using a merged icon fonts (see docs/FONTS.md)
 static void HelpMarker(const char* desc)
@@ -38,7 +46,7 @@ class RenderGuiSystem : public System
 public:
 	RenderGuiSystem() = default;
 
-	void Update(const std::unique_ptr<Registry>& registry, SDL_Rect& camera)
+	void Update(const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera)
 	{
 		ImGui_ImplSDLRenderer_NewFrame();
 		ImGui_ImplSDL2_NewFrame();
@@ -70,6 +78,11 @@ public:
 			const char* sprites[] = { "tank-image", "truck-image" };
 			static int spriteIdx = 0;
 
+			// Static variables for the collision layers of the BoxColliderComponent and the projectiles, as layer indices
+			static int bodyLayerIdx = 0;
+			static int projectileLayerIdx = 0;
+			const int numLayers = static_cast<int>(CollisionLayers::GetNumLayers());
+
 			// Static variables for HealthComponents
 			static int health = 100;
 
@@ -123,6 +136,16 @@ public:
 				projectileAngle = rotation;
 			}
 
+			// Collision layers input section, the masks are the default ones of the layers
+			if (ImGui::CollapsingHeader("Collision", ImGuiTreeNodeFlags_DefaultOpen))
+			{
+				bodyLayerIdx = bodyLayerIdx < numLayers ? bodyLayerIdx : 0;
+				projectileLayerIdx = projectileLayerIdx < numLayers ? projectileLayerIdx : 0;
+				ImGui::Combo("layer##body", &bodyLayerIdx, GetCollisionLayerName, nullptr, numLayers);
+				ImGui::Combo("layer##projectile", &projectileLayerIdx, GetCollisionLayerName, nullptr, numLayers);
+			}
+			ImGui::Spacing();
+
 			// HealthComponent input section
 			if (ImGui::CollapsingHeader("Health", ImGuiTreeNodeFlags_DefaultOpen))
 			{
@@ -145,12 +168,14 @@ public:
 				double bodyVelocityY = bodySpeed * sin(bodyAngle);				
 				enemy.AddComponent<RigidBodyComponent>(glm::vec2(bodyVelocityX, bodyVelocityY));
 
-				enemy.AddComponent<SpriteComponent>(sprites[spriteIdx], 32, 32, 2);
-				enemy.AddComponent<BoxColliderComponent>(25, 20, glm::vec2(5, 5));
+				enemy.AddComponent<SpriteComponent>(assetStore->GetTextureHandle(sprites[spriteIdx]), 32, 32, 2);
+				unsigned int bodyLayer = bodyLayerIdx < numLayers ? 1u << bodyLayerIdx : 0;
+				enemy.AddComponent<BoxColliderComponent>(25, 20, glm::vec2(5, 5), bodyLayer, CollisionLayers::GetDefaultMask(bodyLayer));
 				
 				double projectileVelocityX = projectileSpeed * cos(projectileAngle);
 				double projectileVelocityY = projectileSpeed * sin(projectileAngle);
-				enemy.AddComponent<ProjectileEmitterComponent>(glm::vec2(projectileVelocityX, projectileVelocityY), projectileRepeatFrequency * 1000, projectileDuration * 1000, projectileHitPercentDamage, false);
+				unsigned int projectileLayer = projectileLayerIdx < numLayers ? 1u << projectileLayerIdx : 0;
+				enemy.AddComponent<ProjectileEmitterComponent>(glm::vec2(projectileVelocityX, projectileVelocityY), projectileRepeatFrequency * 1000, projectileDuration * 1000, projectileHitPercentDamage, false, projectileLayer, CollisionLayers::GetDefaultMask(projectileLayer));
 				
 				enemy.AddComponent<HealthComponent>(health);
 
@@ -165,6 +190,42 @@ public:
 		}
 		ImGui::End();
 
+		// Display the collision timings, and allow switching the broadphase to compare them on the current level
+		if (ImGui::Begin("Collision"))
+		{
+			auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+			const auto& stats = collisionSystem.GetStats();
+
+			int broadphaseIdx = collisionSystem.GetBroadphaseType();
+			if (ImGui::Combo("broadphase", &broadphaseIdx, broadphaseNames, IM_ARRAYSIZE(broadphaseNames)))
+			{
+				collisionSystem.SetBroadphase(static_cast<BroadphaseType>(broadphaseIdx));
+			}
+
+			ImGui::Text("colliders: %d (%d static)", stats.numColliders, stats.numStaticColliders);
+			ImGui::Text("candidate pairs: %d", stats.numCandidatePairs);
+			ImGui::Text("contacts: %d (%d entered, %d exited)", stats.numCollisions, stats.numContactsEntered, stats.numContactsExited);
+			ImGui::Text("broadphase: %.3f ms", stats.broadphaseMilliseconds);
+			ImGui::Text("narrowphase: %.3f ms (%d tasks)", stats.narrowphaseMilliseconds, stats.numNarrowphaseTasks);
+
+			bool multithreaded = collisionSystem.IsNarrowphaseMultithreaded();
+			if (ImGui::Checkbox("multithreaded narrowphase", &multithreaded))
+			{
+				collisionSystem.SetMultithreadedNarrowphase(multithreaded);
+			}
+
+			int simdLevelIdx = OverlapKernel::GetSimdLevel();
+			if (ImGui::Combo("overlap kernel", &simdLevelIdx, simdLevelNames, OverlapKernel::DetectSimdLevel() + 1))
+			{
+				OverlapKernel::SetSimdLevel(static_cast<SimdLevel>(simdLevelIdx));
+			}
+			if (ImGui::Button("Benchmark overlap kernels"))
+			{
+				OverlapKernel::Benchmark();
+			}
+		}
+		ImGui::End();
+
 		// DIsplay a small overlay window to display the map position using the mouse
 		ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoNav;
 		ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always, ImVec2(0, 0));
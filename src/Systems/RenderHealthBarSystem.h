@@ -5,16 +5,52 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/HealthComponent.h"
-#include "../AssetStore/AssetStore.h"
+#include "../AssetStore/GlyphAtlas.h"
+#include "../Render/RenderCommandList.h"
+#include "../Render/TextLayout.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 #include <SDL2/SDL.h>
 
 class RenderHealthBarSystem : public System
 {
+private:
+	// The percentage labels, laid out once per health value and font
+	std::map<std::pair<const GlyphAtlas*, int>, TextLayout> healthLabels;
+
+	// Labels of the current update, recorded after all the bars
+	struct HealthLabel
+	{
+		const TextLayout* layout;
+		const GlyphAtlas* glyphAtlas;
+		int x;
+		int y;
+		SDL_Color color;
+	};
+	std::vector<HealthLabel> labels;
+
+	// Fonts of the labels, or null to draw the bars without them
+	const GlyphAtlas* enemyFont = nullptr;
+	const GlyphAtlas* playerFont = nullptr;
+
+	const TextLayout& GetHealthLabel(const GlyphAtlas& glyphAtlas, int healthPercentage)
+	{
+		auto label = healthLabels.find({ &glyphAtlas, healthPercentage });
+		if (label == healthLabels.end())
+		{
+			label = healthLabels.emplace(std::make_pair(&glyphAtlas, healthPercentage), TextLayout()).first;
+			label->second.Build(glyphAtlas, std::to_string(healthPercentage) + "%");
+		}
+		return label->second;
+	}
+
 public:
-	const SDL_Color red = { 255, 0, 0 };
-	const SDL_Color green = { 0, 255, 0 };
-	const SDL_Color orange = { 255, 172, 28 };
-	const SDL_Color gray = { 152, 152, 152 };
+	const SDL_Color red = { 255, 0, 0, 255 };
+	const SDL_Color green = { 0, 255, 0, 255 };
+	const SDL_Color orange = { 255, 172, 28, 255 };
+	const SDL_Color gray = { 152, 152, 152, 255 };
 
 	RenderHealthBarSystem()
 	{
@@ -24,14 +60,26 @@ public:
 		RequireComponent<HealthComponent>();
 	}
 
-	void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera)
+	// Resolved once the level assets are loaded; the labels laid out with the previous fonts are dropped
+	void SetLabelFonts(const GlyphAtlas* enemyFont, const GlyphAtlas* playerFont)
+	{
+		this->enemyFont = enemyFont;
+		this->playerFont = playerFont;
+		healthLabels.clear();
+	}
+
+	// All the bars are recorded before the labels, so that they are drawn in one call, then the labels of each font in one call
+	void Update(RenderCommandList& commandList, const SDL_Rect& camera)
 	{
+		// Labels are recorded after the loop
+		labels.clear();
+
 		// Loop all the entities the system is interested in
 		for (auto entity : GetSystemEntities())
 		{
-			const auto transform = entity.GetComponent<TransformComponent>();
-			const auto sprite = entity.GetComponent<SpriteComponent>();
-			const auto health = entity.GetComponent<HealthComponent>();
+			const auto& transform = entity.GetComponent<TransformComponent>();
+			const auto& sprite = entity.GetComponent<SpriteComponent>();
+			const auto& health = entity.GetComponent<HealthComponent>();
 			
 			SDL_Color color = health.healthPercentage > 70 ? green : (health.healthPercentage > 30 ? orange : red);
 
@@ -39,43 +87,27 @@ public:
 			{
 				const int barWidth = 27;
 
-				int healthLabelPositionX = transform.position.x + (sprite.width * transform.scale.x) + 5;
-				int healthLabelPositionY = transform.position.y - 10;
-
-				SDL_Surface* surface = TTF_RenderText_Blended(
-					assetStore->GetFont("pico8-font-5"),
-					(std::to_string(health.healthPercentage) + "%").c_str(),
-					color);
-
-				SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-				SDL_FreeSurface(surface);
-
-				int labelWidth = 0;
-				int labelHeight = 0;
-
-				SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight);
-
-				SDL_Rect dstRect = {
-					static_cast<int>(healthLabelPositionX - (sprite.isFixed ? 0 : camera.x)),
-					static_cast<int>(healthLabelPositionY - (sprite.isFixed ? 0 : camera.y)),
-					labelWidth,
-					labelHeight
-				};
-
-				SDL_RenderCopy(
-					renderer,
-					texture,
-					NULL,
-					&dstRect
-				);
+				int healthLabelPositionX = static_cast<int>(transform.position.x + (sprite.width * transform.scale.x) + 5 - (sprite.isFixed ? 0 : camera.x));
+				int healthLabelPositionY = static_cast<int>(transform.position.y - 10 - (sprite.isFixed ? 0 : camera.y));
 
 				SDL_Rect fullHealthBar = {
-					static_cast<int>(healthLabelPositionX - 3 - (sprite.isFixed ? 0 : camera.x)),
-					static_cast<int>(healthLabelPositionY + 12 - (sprite.isFixed ? 0 : camera.y)),
+					healthLabelPositionX - 3,
+					healthLabelPositionY + 12,
 					barWidth,
 					5
 				};
 
+				// Cull the bars that are outside the camera view, with the label above them
+				if (fullHealthBar.x + barWidth < 0 || fullHealthBar.x > camera.w || fullHealthBar.y + fullHealthBar.h < 0 || healthLabelPositionY > camera.h)
+				{
+					continue;
+				}
+
+				if (enemyFont)
+				{
+					labels.push_back({ &GetHealthLabel(*enemyFont, health.healthPercentage), enemyFont, healthLabelPositionX, healthLabelPositionY, color });
+				}
+
 				int remainingHealthWidth = static_cast<int>(health.healthPercentage * barWidth / 100);
 
 				if (remainingHealthWidth > barWidth)
@@ -84,16 +116,14 @@ public:
 				}
 
 				SDL_Rect actualHealthBar = {
-					static_cast<int>(healthLabelPositionX - 3 - (sprite.isFixed ? 0 : camera.x)),
-					static_cast<int>(healthLabelPositionY + 12 - (sprite.isFixed ? 0 : camera.y)),
+					fullHealthBar.x,
+					fullHealthBar.y,
 					remainingHealthWidth,
 					5
 				};
 
-				SDL_SetRenderDrawColor(renderer, gray.r, gray.g, gray.b, gray.a);
-				SDL_RenderDrawRect(renderer, &fullHealthBar);
-				SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-				SDL_RenderFillRect(renderer, &actualHealthBar);
+				commandList.AddDrawRect(fullHealthBar, gray);
+				commandList.AddFillRect(actualHealthBar, color);
 			}
 			else if (entity.HasTag("player"))
 			{
@@ -102,34 +132,13 @@ public:
 				int healthBarPositionX = 10;
 				int healthBarPositionY = 10;
 
-				SDL_Surface* surface = TTF_RenderText_Blended(
-					assetStore->GetFont("pico8-font-8"),
-					(std::to_string(health.healthPercentage) + "%").c_str(),
-					color);
-
-				SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-				SDL_FreeSurface(surface);
-
-				int labelWidth = 0;
 				int labelHeight = 0;
-
-				SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight);
-
-				SDL_Rect dstRect = {
-					static_cast<int>(healthBarPositionX + barWidth + 5),
-					static_cast<int>(healthBarPositionY),
-					labelWidth,
-					labelHeight
-				};
-
-				SDL_RenderCopy(
-					renderer,
-					texture,
-					NULL,
-					&dstRect
-				);
-
-				SDL_DestroyTexture(texture);
+				if (playerFont)
+				{
+					const TextLayout& label = GetHealthLabel(*playerFont, health.healthPercentage);
+					labels.push_back({ &label, playerFont, healthBarPositionX + barWidth + 5, healthBarPositionY, color });
+					labelHeight = label.GetHeight();
+				}
 
 				SDL_Rect fullHealthBar = {
 					healthBarPositionX,
@@ -147,13 +156,16 @@ public:
 					labelHeight
 				};
 
-				SDL_SetRenderDrawColor(renderer, gray.r, gray.g, gray.b, gray.a);
-				SDL_RenderDrawRect(renderer, &fullHealthBar);
-				SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-				SDL_RenderFillRect(renderer, &actualHealthBar);
+				commandList.AddDrawRect(fullHealthBar, gray);
+				commandList.AddFillRect(actualHealthBar, color);
 			}
 		}
+
+		for (const auto& label : labels)
+		{
+			label.layout->Draw(commandList, *label.glyphAtlas, label.x, label.y, label.color);
+		}
 	}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,11 +4,28 @@
 #include "../ECS/ECS.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
+#include "../Render/RenderQueue.h"
+#include "../Render/RenderCommandList.h"
+#include "../AssetStore/AssetStore.h"
 #include <algorithm>
+#include <vector>
 #include <SDL2/SDL.h>
 
 class RenderSystem : public System
 {
+private:
+	// The sprites sorted by zIndex, kept from one frame to the next
+	RenderQueue renderQueue;
+
+	// Entities added since the last frame, and the ones whose sprite changed; their sort keys need the asset store
+	std::vector<Entity> entitiesToAdd;
+	std::vector<Entity> changedEntities;
+
+	static uint64_t GetSortKey(Entity entity, const SpriteComponent& sprite, const AssetStore& assetStore)
+	{
+		return RenderQueue::MakeSortKey(sprite.zIndex, sprite.isFixed, assetStore.GetTexturePage(sprite.texture), entity.GetId());
+	}
+
 public:
 	RenderSystem()
 	{
@@ -16,79 +33,95 @@ public:
 		RequireComponent<SpriteComponent>();
 	}
 
-	void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera)
+	void AddEntityToSystem(Entity entity) override
+	{
+		System::AddEntityToSystem(entity);
+		entitiesToAdd.push_back(entity);
+	}
+
+	void RemoveEntityFromSystem(Entity entity) override
 	{
-		// Create a vector with both Sprite and Transform component of all entities
-		struct RenderableEntity
+		System::RemoveEntityFromSystem(entity);
+
+		changedEntities.erase(std::remove(changedEntities.begin(), changedEntities.end(), entity), changedEntities.end());
+
+		auto pending = std::find(entitiesToAdd.begin(), entitiesToAdd.end(), entity);
+		if (pending != entitiesToAdd.end())
 		{
-			TransformComponent transformComponent;
-			SpriteComponent spriteComponent;
-		};
+			entitiesToAdd.erase(pending);
+			return;
+		}
+		renderQueue.Remove(entity);
+	}
 
-		std::vector<RenderableEntity> renderableEntities;
+	// To be called after changing the zIndex, isFixed or texture of a sprite, so that it is sorted again
+	void OnSpriteChanged(Entity entity)
+	{
+		changedEntities.push_back(entity);
+	}
 
-		for (auto entity : GetSystemEntities())
+	// Sprites with the same texture page and zIndex are next to each other in the queue, and drawn in one call
+	void Update(RenderCommandList& commandList, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera)
+	{
+		for (auto entity : entitiesToAdd)
 		{
-			RenderableEntity renderableEntity;
-			renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
-			renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
+			renderQueue.Add(entity, GetSortKey(entity, entity.GetComponent<SpriteComponent>(), *assetStore));
+		}
+		entitiesToAdd.clear();
+
+		// Only the sprites flagged as changed since the last frame get a new key
+		for (auto entity : changedEntities)
+		{
+			renderQueue.SetSortKey(entity, GetSortKey(entity, entity.GetComponent<SpriteComponent>(), *assetStore));
+		}
+		changedEntities.clear();
+		renderQueue.Sort();
+
+		// Loop all the entities the system is interested in, in zIndex order
+		for (int i = 0; i < renderQueue.Size(); i++)
+		{
+			Entity entity = renderQueue[i].entity;
+			const auto& transform = entity.GetComponent<TransformComponent>();
+			const auto& sprite = entity.GetComponent<SpriteComponent>();
 
 			// Bypass rendering entities if they are aouside the camera view
 			bool isOutsideCameraView = (
-				renderableEntity.transformComponent.position.x + (renderableEntity.transformComponent.scale.x * renderableEntity.spriteComponent.width) < camera.x ||
-				renderableEntity.transformComponent.position.x > camera.x + camera.w ||
-				renderableEntity.transformComponent.position.y + (renderableEntity.transformComponent.scale.y * renderableEntity.spriteComponent.height) < camera.y ||
-				renderableEntity.transformComponent.position.y > camera.y + camera.h
+				transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+				transform.position.x > camera.x + camera.w ||
+				transform.position.y + (transform.scale.y * sprite.height) < camera.y ||
+				transform.position.y > camera.y + camera.h
 			);
 
 			// Cull sprites that are outside the camera view (and are not fixed)
-			if (isOutsideCameraView && !renderableEntity.spriteComponent.isFixed)
+			if (isOutsideCameraView && !sprite.isFixed)
 			{
 				continue;
 			}
 
-			renderableEntities.emplace_back(renderableEntity);
-		}
-
-
-		// Sort the vector by the z-index value
-		std::sort(
-			renderableEntities.begin(),
-			renderableEntities.end(),
-			[](const RenderableEntity& a, const RenderableEntity& b) {
-				return a.spriteComponent.zIndex < b.spriteComponent.zIndex;
-			}
-		);
-
-		// Loop all the entities the system is interested in
-		for (auto entity : renderableEntities)
-		{
-			// Update entity position based on its velocity
-			const auto transform = entity.transformComponent;
-			const auto sprite = entity.spriteComponent;
-
-			// Set the source rectangle of our original stprite texture
+			// Set the source rectangle of our original stprite texture, in its region of the texture page
+			SDL_Rect region = assetStore->GetTextureRegion(sprite.texture);
 			SDL_Rect srcRect = sprite.srcRect;
+			srcRect.x += region.x;
+			srcRect.y += region.y;
 
 			// Set the destination rectangle with the x, y position to be rendered
-			SDL_Rect dstRec = {
+			SDL_Rect dstRect = {
 				static_cast<int>(transform.position.x - (!sprite.isFixed ? camera.x : 0)),
 				static_cast<int>(transform.position.y - (!sprite.isFixed ? camera.y : 0)),
 				static_cast<int>(sprite.width * transform.scale.x),
 				static_cast<int>(sprite.height * transform.scale.y)
 			};
 
-			SDL_RenderCopyEx(
-				renderer,
-				assetStore->GetTexture(sprite.assetId),
-				&srcRect,
-				&dstRec,
+			commandList.AddSprite(
+				assetStore->GetTexture(sprite.texture),
+				srcRect,
+				dstRect,
 				transform.rotation,
-				NULL,
 				sprite.flip
 			);
 		}
 	}
+
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,51 +4,73 @@
 #include "../ECS/ECS.h"
 #include "../Components/TextLabelComponent.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Render/RenderCommandList.h"
+#include "../Render/TextLayout.h"
+#include <string>
+#include <unordered_map>
 #include <SDL2/SDL.h>
 
 class RenderTextSystem : public System
 {
+private:
+	// The layout of a label is only built again when its text or font changes
+	struct CachedText
+	{
+		std::string text;
+		const GlyphAtlas* glyphAtlas = nullptr;
+		TextLayout layout;
+	};
+
+	// [Map key = entity id]
+	std::unordered_map<int, CachedText> cachedTexts;
+
 public:
 	RenderTextSystem()
 	{
 		RequireComponent<TextLabelComponent>();
 	}
 
-	void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera)
+	void RemoveEntityFromSystem(Entity entity) override
+	{
+		System::RemoveEntityFromSystem(entity);
+		cachedTexts.erase(entity.GetId());
+	}
+
+	// The glyphs of the labels with the same font are next to each other in the list, and drawn in one call
+	void Update(RenderCommandList& commandList, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera)
 	{
 		// Loop all the entities the system is interested in
 		for (auto entity : GetSystemEntities())
 		{
-			auto textLabel = entity.GetComponent<TextLabelComponent>();
-
-			SDL_Surface* surface = TTF_RenderText_Blended(
-				assetStore->GetFont(textLabel.assetId),
-				textLabel.text.c_str(),
-				textLabel.color);
-
-			SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-			SDL_FreeSurface(surface);
+			const auto& textLabel = entity.GetComponent<TextLabelComponent>();
 
-			int labelWidth = 0;
-			int labelHeight = 0;
+			const GlyphAtlas* glyphAtlas = assetStore->GetGlyphAtlas(textLabel.font);
+			if (!glyphAtlas)
+			{
+				continue;
+			}
 
-			SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight);
+			CachedText& cachedText = cachedTexts[entity.GetId()];
+			if (cachedText.glyphAtlas != glyphAtlas || cachedText.text != textLabel.text)
+			{
+				cachedText.text = textLabel.text;
+				cachedText.glyphAtlas = glyphAtlas;
+				cachedText.layout.Build(*glyphAtlas, textLabel.text);
+			}
 
-			SDL_Rect dstRect = {
-				static_cast<int>(textLabel.position.x - (textLabel.isFixed ? 0 : camera.x)),
-				static_cast<int>(textLabel.position.y - (textLabel.isFixed ? 0 : camera.y)),
-				labelWidth,
-				labelHeight
-			};
+			int x = static_cast<int>(textLabel.position.x - (textLabel.isFixed ? 0 : camera.x));
+			int y = static_cast<int>(textLabel.position.y - (textLabel.isFixed ? 0 : camera.y));
 
-			SDL_RenderCopy(
-				renderer,
-				texture,
-				NULL,
-				&dstRect
-			);
+			// Cull labels that are outside the camera view
+			if (x + cachedText.layout.GetWidth() < 0 || x > camera.w || y + cachedText.layout.GetHeight() < 0 || y > camera.h)
+			{
+				continue;
+			}
 
-			SDL_DestroyTexture(texture);
+			// The label colors are given without alpha, and were always drawn opaque
+			SDL_Color color = textLabel.color;
+			color.a = 255;
+			cachedText.layout.Draw(commandList, *glyphAtlas, x, y, color);
 		}
 	}
 };
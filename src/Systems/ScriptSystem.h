@@ -7,8 +7,12 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
+#include "../Collision/SpatialIndex.h"
 #include "../Logger/Logger.h"
+#include "CollisionSystem.h"
+#include <string>
 #include <tuple>
+#include <vector>
 
 //------------------------------------------
 // C++ functions to bind with Lua functions
@@ -111,13 +115,45 @@ void SetProjectileVelocity(Entity entity, double x, double y)
 
 class ScriptSystem : public System
 {
+private:
+	// Entity ids found by the last spatial query, copied to the table given by the script
+	std::vector<int> queryResults;
+
+	// Queries without a layer name return the colliders of every layer, and the ones with an unknown name none
+	static unsigned int GetQueryMask(const sol::optional<std::string>& layer)
+	{
+		if (!layer)
+		{
+			return COLLISION_MASK_ALL;
+		}
+
+		unsigned int mask = CollisionLayers::FindLayer(*layer);
+		if (mask == 0)
+		{
+			Logger::Err("Spatial query on the unknown collision layer " + *layer);
+		}
+		return mask;
+	}
+
+	// The ids are stored in results[1..count] and results[count + 1] is cleared, so a table can be reused by
+	// every query of a script without allocating anything for the entities found
+	int CopyQueryResults(sol::table& results) const
+	{
+		for (std::size_t i = 0; i < queryResults.size(); i++)
+		{
+			results[i + 1] = queryResults[i];
+		}
+		results[queryResults.size() + 1] = sol::lua_nil;
+		return static_cast<int>(queryResults.size());
+	}
+
 public:
 	ScriptSystem()
 	{
 		RequireComponent<ScriptComponent>();
 	}
 
-	void CreateLuaBinding(sol::state& lua)
+	void CreateLuaBinding(sol::state& lua, std::unique_ptr<Registry>& registry)
 	{
 		// Create the "entity" user type for Lua
 		lua.new_usertype<Entity>(
@@ -136,6 +172,40 @@ public:
 		lua.set_function("set_rotation", SetEntityRotation);
 		lua.set_function("set_animation_frame", SetEntityAnimationFrame);
 		lua.set_function("set_projectile_velocity", SetProjectileVelocity);
+
+		// Spatial queries over the colliders, as of the last collision update; they fill the results table with
+		// entity ids and return their count, and get_entity turns the ids the script is interested in into entities,
+		// or nil if the id is not used by any entity
+		Registry* queryRegistry = registry.get();
+		const SpatialIndex& spatialIndex = registry->GetSystem<CollisionSystem>().GetSpatialIndex();
+
+		lua.set_function("get_entity", [queryRegistry](int entityId) -> sol::optional<Entity> {
+			if (!queryRegistry->IsEntityAlive(entityId))
+			{
+				return sol::nullopt;
+			}
+
+			Entity entity(entityId);
+			entity.registry = queryRegistry;
+			return entity;
+		});
+		lua.set_function("query_rect", [this, &spatialIndex](double x, double y, double width, double height, sol::table results, sol::optional<std::string> layer) {
+			AABB box(static_cast<float>(x), static_cast<float>(y), static_cast<float>(x + width), static_cast<float>(y + height));
+			spatialIndex.QueryRect(box, GetQueryMask(layer), queryResults);
+			return CopyQueryResults(results);
+		});
+		lua.set_function("query_radius", [this, &spatialIndex](double x, double y, double radius, sol::table results, sol::optional<std::string> layer) {
+			spatialIndex.QueryRadius(static_cast<float>(x), static_cast<float>(y), static_cast<float>(radius), GetQueryMask(layer), queryResults);
+			return CopyQueryResults(results);
+		});
+		lua.set_function("query_nearest", [this, &spatialIndex](double x, double y, int k, double maxDistance, sol::table results, sol::optional<std::string> layer) {
+			spatialIndex.QueryNearest(static_cast<float>(x), static_cast<float>(y), k, static_cast<float>(maxDistance), GetQueryMask(layer), queryResults);
+			return CopyQueryResults(results);
+		});
+		lua.set_function("ray_cast", [this, &spatialIndex](double x1, double y1, double x2, double y2, sol::table results, sol::optional<std::string> layer) {
+			spatialIndex.RayCast(static_cast<float>(x1), static_cast<float>(y1), static_cast<float>(x2), static_cast<float>(y2), GetQueryMask(layer), queryResults);
+			return CopyQueryResults(results);
+		});
 	}
 
 	void Update(double deltaTime, int elapsedTime)
@@ -0,0 +1,95 @@
+#include "FramePipeline.h"
+
+FramePipeline::~FramePipeline()
+{
+	Stop();
+}
+
+void FramePipeline::Start(std::function<bool(RenderCommandList&)> produceFrame)
+{
+	Stop();
+
+	readyList = -1;
+	drawnList = -1;
+	stopping = false;
+	producerDone = false;
+	producer = std::thread([this, produceFrame]() { ProducerLoop(produceFrame); });
+}
+
+void FramePipeline::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	listFree.notify_all();
+
+	if (producer.joinable())
+	{
+		producer.join();
+	}
+}
+
+void FramePipeline::ProducerLoop(const std::function<bool(RenderCommandList&)>& produceFrame)
+{
+	while (true)
+	{
+		int list = -1;
+		{
+			// A list can be recorded once the previous frame was taken, and it is not the one being drawn
+			std::unique_lock<std::mutex> lock(mutex);
+			listFree.wait(lock, [this]() { return stopping || readyList == -1; });
+			if (stopping)
+			{
+				break;
+			}
+			list = drawnList == 0 ? 1 : 0;
+		}
+
+		bool isRunning = produceFrame(commandLists[list]);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			readyList = list;
+		}
+		frameReady.notify_one();
+
+		if (!isRunning)
+		{
+			break;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		producerDone = true;
+	}
+	frameReady.notify_one();
+}
+
+const RenderCommandList* FramePipeline::AcquireFrame()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	frameReady.wait(lock, [this]() { return readyList != -1 || producerDone; });
+	if (readyList == -1)
+	{
+		return nullptr;
+	}
+
+	int list = readyList;
+	drawnList = list;
+	readyList = -1;
+	lock.unlock();
+	listFree.notify_one();
+
+	return &commandLists[list];
+}
+
+void FramePipeline::ReleaseFrame()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		drawnList = -1;
+	}
+	listFree.notify_one();
+}
@@ -0,0 +1,56 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include "../Render/RenderCommandList.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*---------------------------------------------------------------------------*/
+// FramePipeline
+/*---------------------------------------------------------------------------*/
+// Overlaps the simulation of a frame with the drawing of the previous one.
+// A thread runs the simulation and records each frame into one of two
+// command lists, while the thread that owns the renderer draws the other
+// one. The simulation waits while a recorded frame has not been taken yet,
+// so it is never more than one frame ahead of what is on screen.
+/*---------------------------------------------------------------------------*/
+class FramePipeline
+{
+private:
+	RenderCommandList commandLists[2];
+
+	// Index of the list recorded and waiting to be drawn, and of the list being drawn (-1 for none)
+	int readyList = -1;
+	int drawnList = -1;
+
+	bool stopping = false;
+	bool producerDone = false;
+
+	std::mutex mutex;
+	std::condition_variable frameReady;
+	std::condition_variable listFree;
+	std::thread producer;
+
+	void ProducerLoop(const std::function<bool(RenderCommandList&)>& produceFrame);
+
+public:
+	FramePipeline() = default;
+	~FramePipeline();
+
+	FramePipeline(const FramePipeline&) = delete;
+	FramePipeline& operator=(const FramePipeline&) = delete;
+
+	// Calls produceFrame on the simulation thread to record every frame, until it returns false or Stop is called
+	void Start(std::function<bool(RenderCommandList&)> produceFrame);
+	void Stop();
+
+	// Waits for the next recorded frame; returns nullptr once no more frames will come
+	const RenderCommandList* AcquireFrame();
+
+	// Gives the list of the acquired frame back to the simulation
+	void ReleaseFrame();
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+#include "../Logger/Logger.h"
+#include <string>
+
+ThreadPool::ThreadPool(unsigned int numWorkers): nextTask(0)
+{
+	if (numWorkers == 0)
+	{
+		unsigned int numHardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = numHardwareThreads > 1 ? numHardwareThreads - 1 : 0;
+	}
+
+	for (unsigned int i = 0; i < numWorkers; i++)
+	{
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	Logger::Log("Thread pool started with " + std::to_string(numWorkers) + " workers");
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workReady.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+int ThreadPool::GetNumThreads() const
+{
+	return static_cast<int>(workers.size()) + 1;
+}
+
+void ThreadPool::RunTasks()
+{
+	for (int task = nextTask++; task < numTasks; task = nextTask++)
+	{
+		(*job)(task);
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned int lastGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			workReady.wait(lock, [&]() { return stopping || generation != lastGeneration; });
+			if (stopping)
+			{
+				return;
+			}
+			lastGeneration = generation;
+		}
+
+		RunTasks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--numBusyWorkers == 0)
+			{
+				workDone.notify_one();
+			}
+		}
+	}
+}
+
+void ThreadPool::ParallelFor(int numTasks, const std::function<void(int)>& job)
+{
+	// Not worth waking up the workers for a single task
+	if (workers.empty() || numTasks <= 1)
+	{
+		for (int task = 0; task < numTasks; task++)
+		{
+			job(task);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+		this->numTasks = numTasks;
+		nextTask = 0;
+		numBusyWorkers = static_cast<int>(workers.size());
+		generation++;
+	}
+	workReady.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	workDone.wait(lock, [this]() { return numBusyWorkers == 0; });
+	this->job = nullptr;
+}
@@ -0,0 +1,53 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*---------------------------------------------------------------------------*/
+// ThreadPool
+/*---------------------------------------------------------------------------*/
+// A fixed set of worker threads that sleep until some work is handed to them.
+// ParallelFor splits the work in numbered tasks; the workers and the calling
+// thread pick the tasks in any order, so a task must only write to its own
+// output and results are merged by task index once ParallelFor returns.
+/*---------------------------------------------------------------------------*/
+class ThreadPool
+{
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable workReady;
+	std::condition_variable workDone;
+
+	// Current ParallelFor call
+	const std::function<void(int)>* job = nullptr;
+	int numTasks = 0;
+	std::atomic<int> nextTask;
+	int numBusyWorkers = 0;
+	unsigned int generation = 0;
+	bool stopping = false;
+
+	void WorkerLoop();
+	void RunTasks();
+
+public:
+	// Zero threads uses one worker less than the number of hardware threads (the caller is the last one)
+	ThreadPool(unsigned int numWorkers = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Number of threads running the tasks, counting the calling thread
+	int GetNumThreads() const;
+
+	// Runs job(task) for every task in [0, numTasks) and waits until all of them are done
+	void ParallelFor(int numTasks, const std::function<void(int)>& job);
+};
+
+#endif
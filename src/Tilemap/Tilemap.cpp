@@ -0,0 +1,75 @@
+#include "Tilemap.h"
+#include "../Logger/Logger.h"
+#include <cctype>
+#include <fstream>
+
+void Tilemap::Reset(int numCols, int numRows, float scale, const Tileset& tileset)
+{
+	this->numCols = std::max(numCols, 0);
+	this->numRows = std::max(numRows, 0);
+	this->scale = scale;
+	this->tileset = tileset;
+	this->tileset.numCols = std::max(tileset.numCols, 1);
+	layers.clear();
+}
+
+int Tilemap::AddLayer()
+{
+	layers.emplace_back(numCols * numRows, EMPTY_TILE);
+	return static_cast<int>(layers.size()) - 1;
+}
+
+bool Tilemap::LoadLayer(const std::string& mapFilePath)
+{
+	std::ifstream mapFile(mapFilePath);
+	if (!mapFile)
+	{
+		Logger::Err("Could not open tilemap file " + mapFilePath);
+		return false;
+	}
+
+	int layer = AddLayer();
+	for (int row = 0; row < numRows; row++)
+	{
+		for (int col = 0; col < numCols; col++)
+		{
+			char tilesetRow;
+			char tilesetCol;
+			if (!mapFile.get(tilesetRow) || !mapFile.get(tilesetCol))
+			{
+				Logger::Err("Tilemap file " + mapFilePath + " has less tiles than the map");
+				return false;
+			}
+			mapFile.ignore();
+
+			if (std::isdigit(tilesetRow) && std::isdigit(tilesetCol))
+			{
+				layers[layer][row * numCols + col] = static_cast<uint16_t>((tilesetRow - '0') * tileset.numCols + (tilesetCol - '0'));
+			}
+		}
+	}
+
+	return true;
+}
+
+void Tilemap::SetTile(int layer, int col, int row, uint16_t tile)
+{
+	if (col < 0 || row < 0 || col >= numCols || row >= numRows)
+	{
+		return;
+	}
+	layers[layer][row * numCols + col] = tile;
+}
+
+bool Tilemap::IsSolid(int col, int row) const
+{
+	for (int layer = 0; layer < GetNumLayers(); layer++)
+	{
+		uint16_t tile = GetTile(layer, col, row);
+		if (tile != EMPTY_TILE && tile < tileset.isSolidTile.size() && tileset.isSolidTile[tile])
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,115 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include "../AssetStore/AssetHandle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+const uint16_t EMPTY_TILE = 0xffff;
+
+// The texture the tiles are cut from; a tile index is (tileset row * numCols + tileset col)
+struct Tileset
+{
+	TextureHandle texture = INVALID_ASSET_HANDLE;
+	int tileSize = 0;
+	int numCols = 10;
+
+	// [Vector index = tile index]
+	std::vector<bool> isSolidTile;
+};
+
+/*---------------------------------------------------------------------------*/
+// Tilemap
+/*---------------------------------------------------------------------------*/
+// The terrain of a level, outside of the ECS: a dense grid of 16-bit tile
+// indices per layer, drawn from the first layer to the last. Iterating the
+// tiles under the camera only visits the visible cells.
+/*---------------------------------------------------------------------------*/
+class Tilemap
+{
+private:
+	int numCols = 0;
+	int numRows = 0;
+	float scale = 1.0f;
+	Tileset tileset;
+
+	// [Outer vector index = layer]
+	// [Inner vector index = row * numCols + col]
+	std::vector<std::vector<uint16_t>> layers;
+
+public:
+	Tilemap() = default;
+	~Tilemap() = default;
+
+	// Clears the layers and sizes the map; scale is the size of a tile in world pixels over its size in the tileset
+	void Reset(int numCols, int numRows, float scale, const Tileset& tileset);
+
+	// Reads a .map file (comma separated "row col" tileset codes, one line per row) as a new layer on top
+	bool LoadLayer(const std::string& mapFilePath);
+	int AddLayer();
+
+	int GetNumCols() const { return numCols; }
+	int GetNumRows() const { return numRows; }
+	int GetNumLayers() const { return static_cast<int>(layers.size()); }
+	float GetScale() const { return scale; }
+	float GetTileWorldSize() const { return tileset.tileSize * scale; }
+	float GetWorldWidth() const { return numCols * GetTileWorldSize(); }
+	float GetWorldHeight() const { return numRows * GetTileWorldSize(); }
+	const Tileset& GetTileset() const { return tileset; }
+
+	uint16_t GetTile(int layer, int col, int row) const
+	{
+		if (col < 0 || row < 0 || col >= numCols || row >= numRows)
+		{
+			return EMPTY_TILE;
+		}
+		return layers[layer][row * numCols + col];
+	}
+
+	void SetTile(int layer, int col, int row, uint16_t tile);
+
+	// A cell is solid if the tile of any layer is
+	bool IsSolid(int col, int row) const;
+
+	// Pixel rectangle of a tile in the tileset texture
+	SDL_Rect GetTileSource(uint16_t tile) const
+	{
+		int size = tileset.tileSize;
+		return { (tile % tileset.numCols) * size, (tile / tileset.numCols) * size, size, size };
+	}
+
+	// Calls callback(col, row, tile) for the non empty tiles of a layer that overlap the world rectangle
+	template <typename TCallback>
+	void ForEachVisibleTile(int layer, const SDL_Rect& view, TCallback callback) const
+	{
+		float tileWorldSize = GetTileWorldSize();
+		if (tileWorldSize <= 0.0f)
+		{
+			return;
+		}
+
+		int firstCol = std::max(static_cast<int>(std::floor(view.x / tileWorldSize)), 0);
+		int firstRow = std::max(static_cast<int>(std::floor(view.y / tileWorldSize)), 0);
+		int lastCol = std::min(static_cast<int>(std::floor((view.x + view.w) / tileWorldSize)), numCols - 1);
+		int lastRow = std::min(static_cast<int>(std::floor((view.y + view.h) / tileWorldSize)), numRows - 1);
+
+		const std::vector<uint16_t>& tiles = layers[layer];
+		for (int row = firstRow; row <= lastRow; row++)
+		{
+			for (int col = firstCol; col <= lastCol; col++)
+			{
+				uint16_t tile = tiles[row * numCols + col];
+				if (tile != EMPTY_TILE)
+				{
+					callback(col, row, tile);
+				}
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "SelfCheck.h"
+#include "../src/Collision/DynamicTreeBroadphase.h"
+#include "../src/Collision/SpatialHashGrid.h"
+#include "../src/Collision/SweepAndPrune.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+// The pairs of boxes that overlap and whose layers can collide, found by testing every pair
+static std::vector<CollisionPair> FindPairsBruteForce(const std::vector<ColliderProxy>& proxies)
+{
+	std::vector<CollisionPair> pairs;
+	for (std::size_t i = 0; i < proxies.size(); i++)
+	{
+		for (std::size_t j = i + 1; j < proxies.size(); j++)
+		{
+			const auto& a = proxies[i];
+			const auto& b = proxies[j];
+			if (a.box.Overlaps(b.box) && CanCollide(a.layer, a.mask, b.layer, b.mask))
+			{
+				pairs.emplace_back(a.entityId, b.entityId);
+			}
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+// Runs a broadphase over frames where the boxes move, appear, disappear and change layers, and compares the
+// candidate pairs whose boxes overlap with the brute force pairs; candidates that can not collide are errors
+static void CheckBroadphase(IBroadphase& broadphase, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(0.0f, 1024.0f);
+	std::uniform_real_distribution<float> size(4.0f, 96.0f);
+	std::uniform_real_distribution<float> step(-6.0f, 6.0f);
+
+	std::vector<ColliderProxy> proxies;
+	int nextEntityId = 0;
+	auto addProxy = [&]() {
+		float x = position(random);
+		float y = position(random);
+		unsigned int layer = 1u << (random() % 4);
+		unsigned int mask = random() % 5 == 0 ? layer : COLLISION_MASK_ALL;
+		proxies.push_back({ nextEntityId++, AABB(x, y, x + size(random), y + size(random)), layer, mask });
+	};
+
+	for (int i = 0; i < 300; i++)
+	{
+		addProxy();
+	}
+
+	bool allMatched = true;
+	bool allCanCollide = true;
+	std::vector<CollisionPair> candidates;
+	for (int frame = 0; frame < 120 && allMatched && allCanCollide; frame++)
+	{
+		for (auto& proxy : proxies)
+		{
+			float dx = step(random);
+			float dy = step(random);
+			proxy.box = AABB(proxy.box.minX + dx, proxy.box.minY + dy, proxy.box.maxX + dx, proxy.box.maxY + dy);
+		}
+
+		if (frame % 5 == 0)
+		{
+			proxies.erase(proxies.begin() + random() % proxies.size());
+			addProxy();
+			addProxy();
+			proxies[random() % proxies.size()].mask ^= 1u;
+		}
+
+		candidates.clear();
+		broadphase.ComputePairs(proxies, candidates);
+
+		std::vector<const ColliderProxy*> proxyPerEntity(nextEntityId, nullptr);
+		for (const auto& proxy : proxies)
+		{
+			proxyPerEntity[proxy.entityId] = &proxy;
+		}
+
+		std::vector<CollisionPair> overlapping;
+		for (const auto& pair : candidates)
+		{
+			const ColliderProxy* a = pair.a < nextEntityId ? proxyPerEntity[pair.a] : nullptr;
+			const ColliderProxy* b = pair.b < nextEntityId ? proxyPerEntity[pair.b] : nullptr;
+			if (!a || !b || !CanCollide(a->layer, a->mask, b->layer, b->mask))
+			{
+				allCanCollide = false;
+				continue;
+			}
+			if (a->box.Overlaps(b->box))
+			{
+				overlapping.push_back(pair);
+			}
+		}
+		std::sort(overlapping.begin(), overlapping.end());
+		overlapping.erase(std::unique(overlapping.begin(), overlapping.end()), overlapping.end());
+
+		allMatched = overlapping == FindPairsBruteForce(proxies);
+	}
+
+	CHECK(allMatched);
+	CHECK(allCanCollide);
+}
+
+// The added and removed pairs of each update have to be the difference between the brute force pairs of the
+// previous and of this frame, as the boxes move, appear and disappear
+static void CheckSweepAndPruneDeltas()
+{
+	std::mt19937 random(9);
+	std::uniform_real_distribution<float> position(0.0f, 512.0f);
+	std::uniform_real_distribution<float> step(-8.0f, 8.0f);
+
+	SweepAndPrune sweepAndPrune;
+	std::vector<ColliderProxy> proxies;
+	for (int entityId = 0; entityId < 150; entityId++)
+	{
+		float x = position(random);
+		float y = position(random);
+		proxies.push_back({ entityId, AABB(x, y, x + 32.0f, y + 32.0f), 1u << (entityId % 3), COLLISION_MASK_ALL });
+	}
+
+	bool deltasMatched = true;
+	std::vector<CollisionPair> previousPairs;
+	std::vector<CollisionPair> candidates;
+	for (int frame = 0; frame < 100 && deltasMatched; frame++)
+	{
+		for (auto& proxy : proxies)
+		{
+			float dx = step(random);
+			float dy = step(random);
+			proxy.box = AABB(proxy.box.minX + dx, proxy.box.minY + dy, proxy.box.maxX + dx, proxy.box.maxY + dy);
+		}
+		if (frame % 10 == 9)
+		{
+			// Moved to the end of the list, then gone for a frame
+			std::swap(proxies[random() % proxies.size()], proxies.back());
+			proxies.pop_back();
+		}
+
+		candidates.clear();
+		sweepAndPrune.ComputePairs(proxies, candidates);
+		std::vector<CollisionPair> currentPairs = FindPairsBruteForce(proxies);
+
+		std::vector<CollisionPair> added;
+		std::vector<CollisionPair> removed;
+		std::set_difference(currentPairs.begin(), currentPairs.end(), previousPairs.begin(), previousPairs.end(), std::back_inserter(added));
+		std::set_difference(previousPairs.begin(), previousPairs.end(), currentPairs.begin(), currentPairs.end(), std::back_inserter(removed));
+		deltasMatched = added == sweepAndPrune.GetAddedPairs() && removed == sweepAndPrune.GetRemovedPairs();
+
+		previousPairs = currentPairs;
+	}
+
+	CHECK(deltasMatched);
+}
+
+void CheckBroadphases()
+{
+	SpatialHashGrid spatialGrid(64.0f);
+	CheckBroadphase(spatialGrid, 1);
+
+	// Cells smaller than the boxes, so that most boxes span several of them
+	SpatialHashGrid smallCellGrid(16.0f);
+	CheckBroadphase(smallCellGrid, 2);
+
+	DynamicTreeBroadphase dynamicTree(8.0f);
+	CheckBroadphase(dynamicTree, 3);
+
+	SweepAndPrune sweepAndPrune;
+	CheckBroadphase(sweepAndPrune, 4);
+	CheckSweepAndPruneDeltas();
+}
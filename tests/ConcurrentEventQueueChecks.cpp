@@ -0,0 +1,80 @@
+#include "SelfCheck.h"
+#include "../src/EventBus/ConcurrentEventQueue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct ProducedEvent
+{
+	int producer;
+	int sequence;
+};
+
+// Producer threads push into small rings while the main thread drains them, so the rings wrap and fill up:
+// every event has to come out once, in the order its producer pushed it, and the stats have to add up
+void CheckConcurrentEventQueue()
+{
+	const int numProducers = 4;
+	const int numEventsPerProducer = 20000;
+	ConcurrentEventQueue<ProducedEvent> queue(numProducers, 64);
+
+	std::atomic<int> numFinished{ 0 };
+	std::vector<long long> numRejected(numProducers, 0);
+	std::vector<std::thread> producers;
+	for (int producer = 0; producer < numProducers; producer++)
+	{
+		producers.emplace_back([&, producer]() {
+			for (int sequence = 0; sequence < numEventsPerProducer; sequence++)
+			{
+				while (!queue.Push(producer, ProducedEvent{ producer, sequence }))
+				{
+					numRejected[producer]++;
+					std::this_thread::yield();
+				}
+			}
+			numFinished++;
+		});
+	}
+
+	std::vector<int> nextSequence(numProducers, 0);
+	bool inOrder = true;
+	auto checkEvent = [&](ProducedEvent& event) {
+		inOrder = inOrder && event.sequence == nextSequence[event.producer];
+		nextSequence[event.producer]++;
+	};
+	while (numFinished < numProducers)
+	{
+		queue.Drain(checkEvent);
+	}
+	queue.Drain(checkEvent);
+
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+
+	bool allDrained = true;
+	long long totalRejected = 0;
+	for (int producer = 0; producer < numProducers; producer++)
+	{
+		allDrained = allDrained && nextSequence[producer] == numEventsPerProducer;
+		totalRejected += numRejected[producer];
+	}
+	CHECK(inOrder);
+	CHECK(allDrained);
+
+	ConcurrentEventQueueStats stats = queue.GetStats();
+	CHECK(stats.numPushed == static_cast<long long>(numProducers) * numEventsPerProducer);
+	CHECK(stats.numRejected == totalRejected);
+	CHECK(stats.capacity == 64 && stats.highWaterMark <= 64);
+
+	// With the producers done, a drain goes through them in index order whatever order they pushed in
+	queue.Push(2, ProducedEvent{ 2, 0 });
+	queue.Push(0, ProducedEvent{ 0, 0 });
+	queue.Push(1, ProducedEvent{ 1, 0 });
+	std::vector<int> producerOrder;
+	queue.Drain([&](ProducedEvent& event) {
+		producerOrder.push_back(event.producer);
+	});
+	CHECK(producerOrder == std::vector<int>({ 0, 1, 2 }));
+}
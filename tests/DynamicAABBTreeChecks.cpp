@@ -0,0 +1,123 @@
+#include "SelfCheck.h"
+#include "../src/Collision/DynamicAABBTree.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Creates, moves and destroys proxies, and compares the box queries and ray casts with a test of every box
+void CheckDynamicAABBTree()
+{
+	std::mt19937 random(6);
+	std::uniform_real_distribution<float> position(0.0f, 2048.0f);
+	std::uniform_real_distribution<float> size(2.0f, 128.0f);
+	std::uniform_real_distribution<float> step(-12.0f, 12.0f);
+
+	const int numEntities = 500;
+	DynamicAABBTree tree(8.0f);
+	std::vector<AABB> boxes(numEntities);
+	std::vector<int> proxyPerEntity(numEntities, NULL_NODE);
+
+	auto randomBox = [&]() {
+		float x = position(random);
+		float y = position(random);
+		return AABB(x, y, x + size(random), y + size(random));
+	};
+
+	bool queriesMatched = true;
+	bool rayCastsMatched = true;
+	bool stayedBalanced = true;
+	for (int frame = 0; frame < 60; frame++)
+	{
+		for (int entityId = 0; entityId < numEntities; entityId++)
+		{
+			int& proxyId = proxyPerEntity[entityId];
+			if (proxyId == NULL_NODE)
+			{
+				if (random() % 4 != 0)
+				{
+					boxes[entityId] = randomBox();
+					proxyId = tree.CreateProxy(boxes[entityId], entityId);
+				}
+			}
+			else if (random() % 50 == 0)
+			{
+				tree.DestroyProxy(proxyId);
+				proxyId = NULL_NODE;
+			}
+			else
+			{
+				// Mostly small steps that stay in the fat box, sometimes a jump across the map
+				AABB& box = boxes[entityId];
+				if (random() % 20 == 0)
+				{
+					box = randomBox();
+				}
+				else
+				{
+					float dx = step(random);
+					float dy = step(random);
+					box = AABB(box.minX + dx, box.minY + dy, box.maxX + dx, box.maxY + dy);
+				}
+				tree.MoveProxy(proxyId, box);
+			}
+		}
+
+		for (int query = 0; query < 20; query++)
+		{
+			AABB queryBox = randomBox();
+			std::vector<int> found;
+			tree.Query(queryBox, [&](int entityId) {
+				found.push_back(entityId);
+				return true;
+			});
+			std::sort(found.begin(), found.end());
+
+			std::vector<int> expected;
+			for (int entityId = 0; entityId < numEntities; entityId++)
+			{
+				if (proxyPerEntity[entityId] != NULL_NODE && boxes[entityId].Overlaps(queryBox))
+				{
+					expected.push_back(entityId);
+				}
+			}
+			queriesMatched = queriesMatched && found == expected;
+
+			float x1 = position(random);
+			float y1 = position(random);
+			float x2 = position(random);
+			float y2 = position(random);
+			std::vector<std::pair<int, float>> hits;
+			tree.RayCast(x1, y1, x2, y2, [&](int entityId, float entryFraction) {
+				hits.emplace_back(entityId, entryFraction);
+				return true;
+			});
+			std::sort(hits.begin(), hits.end());
+
+			std::vector<std::pair<int, float>> expectedHits;
+			for (int entityId = 0; entityId < numEntities; entityId++)
+			{
+				float entryFraction;
+				if (proxyPerEntity[entityId] != NULL_NODE && boxes[entityId].IntersectsSegment(x1, y1, x2, y2, entryFraction))
+				{
+					expectedHits.emplace_back(entityId, entryFraction);
+				}
+			}
+			rayCastsMatched = rayCastsMatched && hits == expectedHits;
+		}
+
+		// A balanced tree of at most 500 leaves is far below this height
+		stayedBalanced = stayedBalanced && tree.GetHeight() < 24;
+	}
+
+	CHECK(queriesMatched);
+	CHECK(rayCastsMatched);
+	CHECK(stayedBalanced);
+
+	// Stopping early: the callback returning false ends the query after the first hit
+	int numCalls = 0;
+	tree.Query(AABB(0.0f, 0.0f, 4096.0f, 4096.0f), [&](int) {
+		numCalls++;
+		return false;
+	});
+	CHECK(numCalls == 1);
+}
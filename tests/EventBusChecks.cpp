@@ -0,0 +1,83 @@
+#include "SelfCheck.h"
+#include "../src/EventBus/EventBus.h"
+#include <vector>
+
+class NumberEvent: public Event
+{
+public:
+	int number;
+	NumberEvent(int number): number(number) {}
+};
+
+class EchoEvent: public Event
+{
+public:
+	int number;
+	EchoEvent(int number): number(number) {}
+};
+
+// Records what it receives; echoes the first numbers back on the bus as NumberEvents
+class EventRecorder
+{
+public:
+	EventBus* eventBus = nullptr;
+	std::vector<int> numbers;
+	std::vector<std::size_t> batchSizes;
+	int numEchoes = 0;
+
+	void OnNumber(NumberEvent& event)
+	{
+		numbers.push_back(event.number);
+	}
+
+	void OnNumbers(EventSpan<NumberEvent> events)
+	{
+		batchSizes.push_back(events.size());
+	}
+
+	void OnEcho(EchoEvent& event)
+	{
+		if (numEchoes++ < 2)
+		{
+			eventBus->EmitEvent<NumberEvent>(event.number);
+		}
+	}
+};
+
+// Queued mode holds the events until the flush, delivers each type in emit order, hands the batch handlers the
+// whole queue at once, and dispatches the events queued by the handlers in a later round of the same flush
+void CheckEventBus()
+{
+	EventBus eventBus;
+	EventRecorder recorder;
+	recorder.eventBus = &eventBus;
+	eventBus.SubscribeToEvent<&EventRecorder::OnNumber>(&recorder);
+	eventBus.SubscribeToEvent<&EventRecorder::OnNumbers>(&recorder);
+	eventBus.SubscribeToEvent<&EventRecorder::OnEcho>(&recorder);
+
+	eventBus.EmitEvent<NumberEvent>(1);
+	CHECK(recorder.numbers == std::vector<int>({ 1 }));
+
+	eventBus.SetDispatchMode(EVENT_DISPATCH_QUEUED);
+	eventBus.EmitEvent<NumberEvent>(2);
+	eventBus.EmitEvent<EchoEvent>(100);
+	eventBus.EmitEvent<NumberEvent>(3);
+	eventBus.EmitEvent<EchoEvent>(200);
+	eventBus.EmitEvent<EchoEvent>(300);
+	eventBus.EmitEvent<NumberEvent>(4);
+	CHECK(recorder.numbers.size() == 1);
+
+	eventBus.Flush();
+	CHECK(recorder.numbers == std::vector<int>({ 1, 2, 3, 4, 100, 200 }));
+	CHECK(recorder.batchSizes == std::vector<std::size_t>({ 1, 3, 2 }));
+
+	// Nothing is left for the next flush
+	eventBus.Flush();
+	CHECK(recorder.numbers.size() == 6);
+
+	// Events without subscribers are not queued at all
+	eventBus.Reset();
+	eventBus.EmitEvent<NumberEvent>(5);
+	eventBus.Flush();
+	CHECK(recorder.numbers.size() == 6);
+}
@@ -0,0 +1,67 @@
+#include "SelfCheck.h"
+#include "../src/Collision/OverlapKernel.h"
+#include <random>
+#include <vector>
+
+// Compares the hit mask of every kernel the CPU supports with AABB::Overlaps, for batch sizes that are not a
+// multiple of the SIMD width and for boxes that only touch, which the strict comparisons must not count
+void CheckOverlapKernels()
+{
+	std::mt19937 random(5);
+	std::uniform_int_distribution<int> coordinate(0, 64);
+	std::uniform_int_distribution<int> size(1, 16);
+
+	auto randomBox = [&]() {
+		// Integer coordinates, so that many boxes share an edge
+		float x = static_cast<float>(coordinate(random));
+		float y = static_cast<float>(coordinate(random));
+		return AABB(x, y, x + size(random), y + size(random));
+	};
+
+	SimdLevel detectedLevel = OverlapKernel::GetSimdLevel();
+	const int batchSizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 100 };
+
+	for (int level = SIMD_SCALAR; level <= SIMD_AVX512; level++)
+	{
+		if (!OverlapKernel::IsSupported(static_cast<SimdLevel>(level)))
+		{
+			continue;
+		}
+		OverlapKernel::SetSimdLevel(static_cast<SimdLevel>(level));
+
+		bool allMatched = true;
+		for (int batchSize : batchSizes)
+		{
+			AABBArrays boxes;
+			std::vector<AABB> reference;
+			for (int i = 0; i < batchSize; i++)
+			{
+				reference.push_back(randomBox());
+				boxes.Add(reference.back());
+			}
+
+			for (int query = 0; query < 50; query++)
+			{
+				AABB box = randomBox();
+				std::vector<uint32_t> hitMask((batchSize + 31) / 32 + 1, 0xdeadbeef);
+				OverlapKernel::ComputeOverlapMask(box, boxes, hitMask.data());
+
+				for (int i = 0; i < batchSize; i++)
+				{
+					bool hit = (hitMask[i / 32] >> (i % 32)) & 1u;
+					allMatched = allMatched && hit == box.Overlaps(reference[i]);
+				}
+				for (int i = batchSize; i < static_cast<int>((batchSize + 31) / 32) * 32; i++)
+				{
+					// The bits past the last box of the last word are cleared
+					allMatched = allMatched && ((hitMask[i / 32] >> (i % 32)) & 1u) == 0;
+				}
+				// The word after the mask is left untouched
+				allMatched = allMatched && hitMask.back() == 0xdeadbeef;
+			}
+		}
+		CHECK(allMatched);
+	}
+
+	OverlapKernel::SetSimdLevel(detectedLevel);
+}
@@ -0,0 +1,68 @@
+#include "SelfCheck.h"
+#include "../src/AssetStore/RectanglePacker.h"
+#include <random>
+#include <vector>
+
+struct PackedRect
+{
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+// Packs random rectangles until the page is full: every packed rectangle has to lie inside the page without
+// overlapping another one, the page has to end up mostly used, and a rectangle larger than the page never fits
+void CheckRectanglePacker()
+{
+	const int pageWidth = 512;
+	const int pageHeight = 512;
+	std::mt19937 random(8);
+	std::uniform_int_distribution<int> size(1, 64);
+
+	RectanglePacker packer(pageWidth, pageHeight);
+	std::vector<PackedRect> packed;
+	int numFailedInARow = 0;
+	while (numFailedInARow < 100)
+	{
+		PackedRect rect = { 0, 0, size(random), size(random) };
+		if (packer.Pack(rect.width, rect.height, rect.x, rect.y))
+		{
+			packed.push_back(rect);
+			numFailedInARow = 0;
+		}
+		else
+		{
+			numFailedInARow++;
+		}
+	}
+
+	bool allInside = true;
+	bool noneOverlap = true;
+	long long usedArea = 0;
+	for (std::size_t i = 0; i < packed.size(); i++)
+	{
+		const PackedRect& a = packed[i];
+		allInside = allInside && a.x >= 0 && a.y >= 0 && a.x + a.width <= pageWidth && a.y + a.height <= pageHeight;
+		usedArea += static_cast<long long>(a.width) * a.height;
+
+		for (std::size_t j = i + 1; j < packed.size(); j++)
+		{
+			const PackedRect& b = packed[j];
+			bool overlap = a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+			noneOverlap = noneOverlap && !overlap;
+		}
+	}
+
+	CHECK(allInside);
+	CHECK(noneOverlap);
+	CHECK(usedArea * 10 >= static_cast<long long>(pageWidth) * pageHeight * 7);
+
+	RectanglePacker emptyPacker(pageWidth, pageHeight);
+	int x;
+	int y;
+	CHECK(!emptyPacker.Pack(pageWidth + 1, 1, x, y));
+	CHECK(!emptyPacker.Pack(1, pageHeight + 1, x, y));
+	CHECK(emptyPacker.Pack(pageWidth, pageHeight, x, y) && x == 0 && y == 0);
+	CHECK(!emptyPacker.Pack(1, 1, x, y));
+}
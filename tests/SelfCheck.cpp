@@ -0,0 +1,41 @@
+#include "SelfCheck.h"
+#include "../src/Logger/Logger.h"
+
+int SelfCheck::numChecks = 0;
+int SelfCheck::numFailures = 0;
+
+void SelfCheck::Check(bool passed, const char* condition, const char* file, int line)
+{
+	numChecks++;
+	if (!passed)
+	{
+		numFailures++;
+		Logger::Err(std::string(file) + ":" + std::to_string(line) + ": check failed: " + condition);
+	}
+}
+
+int SelfCheck::Report()
+{
+	if (numFailures > 0)
+	{
+		Logger::Err(std::to_string(numFailures) + " of " + std::to_string(numChecks) + " checks failed");
+		return 1;
+	}
+
+	Logger::Log("All " + std::to_string(numChecks) + " checks passed");
+	return 0;
+}
+
+int main()
+{
+	CheckBroadphases();
+	CheckOverlapKernels();
+	CheckDynamicAABBTree();
+	CheckSpatialIndex();
+	CheckEventBus();
+	CheckConcurrentEventQueue();
+	CheckRectanglePacker();
+	CheckTileCollisionGrid();
+
+	return SelfCheck::Report();
+}
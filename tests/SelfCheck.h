@@ -0,0 +1,39 @@
+#ifndef SELF_CHECK_H
+#define SELF_CHECK_H
+
+#include <string>
+
+// Logs the failed condition with its location; the run carries on with the next check
+#define CHECK(condition) SelfCheck::Check((condition), #condition, __FILE__, __LINE__)
+
+/*---------------------------------------------------------------------------*/
+// SelfCheck
+/*---------------------------------------------------------------------------*/
+// Checks of the engine modules that do not need SDL, like the broadphases
+// against a brute force pair search. Built and run with "make selfcheck",
+// which fails if any check fails.
+/*---------------------------------------------------------------------------*/
+class SelfCheck
+{
+private:
+	static int numChecks;
+	static int numFailures;
+
+public:
+	static void Check(bool passed, const char* condition, const char* file, int line);
+
+	// Logs the totals and returns the exit code of the run
+	static int Report();
+};
+
+// One function per group of checks, each in its own file
+void CheckBroadphases();
+void CheckOverlapKernels();
+void CheckDynamicAABBTree();
+void CheckSpatialIndex();
+void CheckEventBus();
+void CheckConcurrentEventQueue();
+void CheckRectanglePacker();
+void CheckTileCollisionGrid();
+
+#endif
@@ -0,0 +1,139 @@
+#include "SelfCheck.h"
+#include "../src/Collision/SpatialIndex.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Distance from the point to the closest point of the box, squared
+static float GetDistanceSquared(const AABB& box, float x, float y)
+{
+	float deltaX = std::max(std::max(box.minX - x, 0.0f), x - box.maxX);
+	float deltaY = std::max(std::max(box.minY - y, 0.0f), y - box.maxY);
+	return deltaX * deltaX + deltaY * deltaY;
+}
+
+// Compares the rect, radius, nearest and ray queries of the index with a test of every box, with layer masks
+void CheckSpatialIndex()
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> position(0.0f, 2000.0f);
+	std::uniform_real_distribution<float> size(4.0f, 48.0f);
+	std::uniform_real_distribution<float> radius(0.0f, 300.0f);
+
+	const int numEntities = 400;
+	SpatialIndex index;
+	std::vector<AABB> boxes(numEntities);
+	std::vector<unsigned int> layers(numEntities);
+	std::vector<bool> inIndex(numEntities, false);
+
+	bool rectsMatched = true;
+	bool radiusesMatched = true;
+	bool nearestMatched = true;
+	bool rayCastsMatched = true;
+	std::vector<int> results;
+	for (int frame = 0; frame < 40; frame++)
+	{
+		for (int entityId = 0; entityId < numEntities; entityId++)
+		{
+			if (random() % 30 == 0)
+			{
+				index.Remove(entityId);
+				inIndex[entityId] = false;
+				continue;
+			}
+			float x = position(random);
+			float y = position(random);
+			boxes[entityId] = AABB(x, y, x + size(random), y + size(random));
+			layers[entityId] = 1u << (random() % 3);
+			index.SetBox(entityId, boxes[entityId], layers[entityId]);
+			inIndex[entityId] = true;
+		}
+
+		for (int query = 0; query < 10; query++)
+		{
+			float x = position(random);
+			float y = position(random);
+			float queryRadius = radius(random);
+			unsigned int mask = random() % 7 + 1;
+
+			// Distances of the entities in the mask, with their ids, sorted the way QueryNearest breaks ties
+			std::vector<std::pair<float, int>> distances;
+			for (int entityId = 0; entityId < numEntities; entityId++)
+			{
+				if (inIndex[entityId] && (layers[entityId] & mask))
+				{
+					distances.emplace_back(GetDistanceSquared(boxes[entityId], x, y), entityId);
+				}
+			}
+			std::sort(distances.begin(), distances.end());
+
+			AABB queryBox(x - queryRadius, y - queryRadius, x + queryRadius, y + queryRadius);
+			index.QueryRect(queryBox, mask, results);
+			std::sort(results.begin(), results.end());
+			std::vector<int> expected;
+			for (int entityId = 0; entityId < numEntities; entityId++)
+			{
+				if (inIndex[entityId] && (layers[entityId] & mask) && boxes[entityId].Overlaps(queryBox))
+				{
+					expected.push_back(entityId);
+				}
+			}
+			rectsMatched = rectsMatched && results == expected;
+
+			index.QueryRadius(x, y, queryRadius, mask, results);
+			std::sort(results.begin(), results.end());
+			expected.clear();
+			for (const auto& distance : distances)
+			{
+				if (distance.first <= queryRadius * queryRadius)
+				{
+					expected.push_back(distance.second);
+				}
+			}
+			std::sort(expected.begin(), expected.end());
+			radiusesMatched = radiusesMatched && results == expected;
+
+			// Once unbounded, once limited to the radius
+			int k = 1 + random() % 12;
+			for (float maxDistance : { 1e9f, queryRadius })
+			{
+				index.QueryNearest(x, y, k, maxDistance, mask, results);
+				expected.clear();
+				for (const auto& distance : distances)
+				{
+					if (static_cast<int>(expected.size()) < k && distance.first <= maxDistance * maxDistance)
+					{
+						expected.push_back(distance.second);
+					}
+				}
+				nearestMatched = nearestMatched && results == expected;
+			}
+
+			float x2 = position(random);
+			float y2 = position(random);
+			index.RayCast(x, y, x2, y2, mask, results);
+			std::vector<std::pair<float, int>> hits;
+			for (int entityId = 0; entityId < numEntities; entityId++)
+			{
+				float entryFraction;
+				if (inIndex[entityId] && (layers[entityId] & mask) && boxes[entityId].IntersectsSegment(x, y, x2, y2, entryFraction))
+				{
+					hits.emplace_back(entryFraction, entityId);
+				}
+			}
+			std::sort(hits.begin(), hits.end());
+			expected.clear();
+			for (const auto& hit : hits)
+			{
+				expected.push_back(hit.second);
+			}
+			rayCastsMatched = rayCastsMatched && results == expected;
+		}
+	}
+
+	CHECK(rectsMatched);
+	CHECK(radiusesMatched);
+	CHECK(nearestMatched);
+	CHECK(rayCastsMatched);
+	CHECK(index.QueryNearest(0.0f, 0.0f, 5, 1e9f, 0, results) == 0);
+}
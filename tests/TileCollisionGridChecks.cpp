@@ -0,0 +1,99 @@
+#include "SelfCheck.h"
+#include "../src/Collision/TileCollisionGrid.h"
+#include <algorithm>
+#include <random>
+
+// Open interval of the move (as a fraction) during which the box overlaps the range on one axis
+static void GetOverlapFractions(float boxMin, float boxMax, float delta, float rangeMin, float rangeMax, float& entry, float& exit)
+{
+	if (delta == 0.0f)
+	{
+		bool overlaps = boxMin < rangeMax && boxMax > rangeMin;
+		entry = overlaps ? -1.0f : 2.0f;
+		exit = overlaps ? 2.0f : -1.0f;
+		return;
+	}
+
+	float t1 = (rangeMin - boxMax) / delta;
+	float t2 = (rangeMax - boxMin) / delta;
+	entry = std::min(t1, t2);
+	exit = std::max(t1, t2);
+}
+
+// Whether the box overlaps a solid tile at some point of its move, testing every tile of the grid
+static bool SweepOverlapsSolidBruteForce(const TileCollisionGrid& grid, const AABB& box, float deltaX, float deltaY)
+{
+	float tileSize = grid.GetTileSize();
+	for (int row = 0; row < grid.GetNumRows(); row++)
+	{
+		for (int col = 0; col < grid.GetNumCols(); col++)
+		{
+			if (!grid.IsSolid(col, row))
+			{
+				continue;
+			}
+
+			float entryX, exitX, entryY, exitY;
+			GetOverlapFractions(box.minX, box.maxX, deltaX, col * tileSize, (col + 1) * tileSize, entryX, exitX);
+			GetOverlapFractions(box.minY, box.maxY, deltaY, row * tileSize, (row + 1) * tileSize, entryY, exitY);
+			float entry = std::max(entryX, entryY);
+			float exit = std::min(exitX, exitY);
+			if (entry < exit && entry < 1.0f && exit > 0.0f)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Compares the static and swept tests of random boxes with a test of every tile, then checks that a box
+// passing diagonally by a tile corner misses it and that a fast box does not skip over a tile
+void CheckTileCollisionGrid()
+{
+	const float tileSize = 32.0f;
+	TileCollisionGrid grid;
+	grid.Reset(20, 15, tileSize);
+
+	std::mt19937 random(10);
+	for (int i = 0; i < 40; i++)
+	{
+		grid.SetSolid(random() % 20, random() % 15, true);
+	}
+
+	std::uniform_real_distribution<float> position(-40.0f, 680.0f);
+	std::uniform_real_distribution<float> size(1.0f, 24.0f);
+	std::uniform_real_distribution<float> delta(-200.0f, 200.0f);
+
+	bool overlapsMatched = true;
+	bool sweepsMatched = true;
+	for (int i = 0; i < 20000; i++)
+	{
+		float x = position(random);
+		float y = position(random);
+		AABB box(x, y, x + size(random), y + size(random));
+
+		overlapsMatched = overlapsMatched && grid.OverlapsSolid(box) == SweepOverlapsSolidBruteForce(grid, box, 0.0f, 0.0f);
+
+		// Also the axis-aligned moves
+		float deltaX = i % 5 == 1 ? 0.0f : delta(random);
+		float deltaY = i % 5 == 2 ? 0.0f : delta(random);
+		sweepsMatched = sweepsMatched && grid.SweepOverlapsSolid(box, deltaX, deltaY) == SweepOverlapsSolidBruteForce(grid, box, deltaX, deltaY);
+	}
+	CHECK(overlapsMatched);
+	CHECK(sweepsMatched);
+
+	// A single solid tile from (64, 64) to (96, 96)
+	grid.Reset(10, 10, tileSize);
+	grid.SetSolid(2, 2, true);
+
+	// Moving up and right past its top-left corner: the box leaves the rows of the tile before reaching its columns
+	AABB bullet(30.0f, 80.0f, 34.0f, 84.0f);
+	CHECK(!grid.SweepOverlapsSolid(bullet, 40.0f, -40.0f));
+
+	// Crossing the whole tile in one move, from the left of it to the right of it
+	AABB fastBullet(0.0f, 70.0f, 4.0f, 74.0f);
+	CHECK(!grid.OverlapsSolid(AABB(200.0f, 70.0f, 204.0f, 74.0f)));
+	CHECK(grid.SweepOverlapsSolid(fastBullet, 200.0f, 0.0f));
+}